@@ -3,10 +3,14 @@
 #include "op/grid.hpp"
 #include "info.hpp"
 #include "log.hpp"
+#include "threads.hpp"
 #include "traj_spirals.hpp"
 
 #include <catch2/benchmark/catch_benchmark_all.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cfenv>
 
 using namespace rl;
 
@@ -56,7 +60,8 @@ TEST_CASE("Grid ES5", "[grid]")
 
 TEST_CASE("GridBasis ES3", "[grid]")
 {
-  Index const nB = 4;
+  Log::SetLevel(Log::Level::Testing);
+  Index const nB = GENERATE(4, 8, 16);
   Basis basis(nB, 1, 256);
   auto grid = TOps::Grid<3>::Make(traj, "ES3", os, C, &basis);
   Cx5  c(grid->ishape);
@@ -67,15 +72,16 @@ TEST_CASE("GridBasis ES3", "[grid]")
   Cx3Map  mnc(nc.data(), nc.dimensions());
   Cx5CMap cc(c.data(), c.dimensions());
   Cx3CMap cnc(nc.data(), nc.dimensions());
-  BENCHMARK("forward") { grid->forward(cc, mnc); };
-  BENCHMARK("iforward") { grid->iforward(cc, mnc); };
-  BENCHMARK("adjoint") { grid->adjoint(cnc, mc); };
-  BENCHMARK("iadjoint") { grid->iadjoint(cnc, mc); };
+  BENCHMARK(fmt::format("forward {}", nB)) { grid->forward(cc, mnc); };
+  BENCHMARK(fmt::format("iforward {}", nB)) { grid->iforward(cc, mnc); };
+  BENCHMARK(fmt::format("adjoint {}", nB)) { grid->adjoint(cnc, mc); };
+  BENCHMARK(fmt::format("iadjoint {}", nB)) { grid->iadjoint(cnc, mc); };
 }
 
 TEST_CASE("GridBasis ES5", "[grid]")
 {
-  Index const nB = 4;
+  Log::SetLevel(Log::Level::Testing);
+  Index const nB = GENERATE(4, 8, 16);
   Basis basis(nB, 1, 256);
   auto grid = TOps::Grid<3>::Make(traj, "ES5", os, C, &basis);
   Cx5  c(grid->ishape);
@@ -86,8 +92,124 @@ TEST_CASE("GridBasis ES5", "[grid]")
   Cx3Map  mnc(nc.data(), nc.dimensions());
   Cx5CMap cc(c.data(), c.dimensions());
   Cx3CMap cnc(nc.data(), nc.dimensions());
-  BENCHMARK("forward") { grid->forward(cc, mnc); };
-  BENCHMARK("iforward") { grid->iforward(cc, mnc); };
-  BENCHMARK("adjoint") { grid->adjoint(cnc, mc); };
-  BENCHMARK("iadjoint") { grid->iadjoint(cnc, mc); };
+  BENCHMARK(fmt::format("forward {}", nB)) { grid->forward(cc, mnc); };
+  BENCHMARK(fmt::format("adjoint {}", nB)) { grid->adjoint(cnc, mc); };
+}
+
+TEST_CASE("GridBasis Fused", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const nB = GENERATE(4, 8, 16);
+  Basis basis(nB, 1, 256);
+  auto grid = TOps::Grid<3>::Make(traj, "ES5", os, C, &basis);
+  Cx5  c(grid->ishape);
+  Cx3  nc(grid->oshape);
+  c.setRandom();
+  nc.setRandom();
+  Cx5Map  mc(c.data(), c.dimensions());
+  Cx3Map  mnc(nc.data(), nc.dimensions());
+  Cx5CMap cc(c.data(), c.dimensions());
+  Cx3CMap cnc(nc.data(), nc.dimensions());
+  BENCHMARK(fmt::format("per-sample forward {}", nB))
+  {
+    grid->fused = false;
+    grid->forward(cc, mnc);
+  };
+  BENCHMARK(fmt::format("fused forward {}", nB))
+  {
+    grid->fused = true;
+    grid->forward(cc, mnc);
+  };
+  BENCHMARK(fmt::format("per-sample adjoint {}", nB))
+  {
+    grid->fused = false;
+    grid->adjoint(cnc, mc);
+  };
+  BENCHMARK(fmt::format("fused adjoint {}", nB))
+  {
+    grid->fused = true;
+    grid->adjoint(cnc, mc);
+  };
+}
+
+TEST_CASE("Grid Adjoint Threads", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  auto grid = TOps::Grid<3>::Make(traj, "ES5", os, C, &basis);
+  Cx5  c(grid->ishape);
+  Cx3  nc(grid->oshape);
+  nc.setRandom();
+  Cx5Map      mc(c.data(), c.dimensions());
+  Cx3CMap     cnc(nc.data(), nc.dimensions());
+  Index const nT = GENERATE(8, 16, 32, 64, 128);
+  Threads::SetGlobalThreadCount(nT);
+  BENCHMARK(fmt::format("mutex {}", nT))
+  {
+    grid->coloured = false;
+    grid->adjoint(cnc, mc);
+  };
+  BENCHMARK(fmt::format("coloured {}", nT))
+  {
+    grid->coloured = true;
+    grid->adjoint(cnc, mc);
+  };
+  Threads::SetGlobalThreadCount(0);
+}
+
+namespace {
+/* The original mapping layout, with the subgrid stored in every mapping */
+template <int ND> struct OldMapping
+{
+  std::array<int16_t, ND>    cart;
+  int16_t                    sample;
+  int32_t                    trace;
+  Eigen::Array<float, ND, 1> offset;
+  Sz<ND>                     subgrid;
+};
+
+/* The original single-threaded push_back and sort, for comparison */
+template <int ND> auto SerialMapping(TrajectoryN<ND> const &traj, float const nomOS, Index const kW, Index const sgSz)
+{
+  auto const  cartDims = Mul(traj.matrix(), nomOS);
+  float const osamp = cartDims[0] / (float)traj.matrix()[0];
+  auto const  center = Div(cartDims, 2);
+  std::fesetround(FE_TONEAREST);
+  std::vector<OldMapping<ND>> mappings;
+  for (int32_t it = 0; it < traj.nTraces(); it++) {
+    for (int16_t is = 0; is < traj.nSamples(); is++) {
+      Re1 const p = traj.point(is, it);
+      if (!B0(p.isfinite().all())()) { continue; }
+      Eigen::Array<float, ND, 1> xyz;
+      for (Index ii = 0; ii < ND; ii++) {
+        xyz[ii] = p[ii] * osamp + center[ii];
+      }
+      Eigen::Array<float, ND, 1> const gp = xyz.unaryExpr([](float const e) { return std::nearbyint(e); });
+      OldMapping<ND>                   m{.sample = is, .trace = it, .offset = xyz - gp};
+      for (Index id = 0; id < ND; id++) {
+        Index const ijk = Wrap((Index)gp[id], cartDims[id]);
+        m.subgrid[id] = sgSz * (ijk / sgSz) - (kW / 2);
+        m.cart[id] = ijk - m.subgrid[id];
+      }
+      mappings.push_back(m);
+    }
+  }
+  std::sort(mappings.begin(), mappings.end(), [](OldMapping<ND> const &a, OldMapping<ND> const &b) {
+    for (Index id = ND - 1; id >= 0; id--) {
+      if (a.subgrid[id] != b.subgrid[id]) { return a.subgrid[id] < b.subgrid[id]; }
+    }
+    for (Index id = ND - 1; id >= 0; id--) {
+      if (a.cart[id] != b.cart[id]) { return a.cart[id] < b.cart[id]; }
+    }
+    return false;
+  });
+  return mappings;
+}
+} // namespace
+
+TEST_CASE("Grid Mapping", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Trajectory const big(ArchimedeanSpiral(2 * M, 1.f, 4 * traces));
+  BENCHMARK("serial") { return SerialMapping(big, os, 6, 32).size(); };
+  BENCHMARK("parallel") { return CalcMapping(big, os, 6, 32).mappings.size(); };
 }
@@ -20,15 +20,61 @@ TEST_CASE("Kernels", "[kernels]")
   Index const C = 8;
   Cx1         b(B);
   b.setRandom();
-  Cx5 x(B, C, 16, 16, 16);
+  Cx5    x(B, C, 16, 16, 16);
+  Cx5Map xm(x.data(), x.dimensions());
   x.setRandom();
   Cx1                          y(C);
   Cx1Map                       ym(y.data(), Sz1{8});
   std::array<int16_t, 3> const c{8, 8, 8};
 
-  BENCHMARK(fmt::format("ES3 Spread {}", B)) { es3.spread(c, p, b, y, x); };  
+  BENCHMARK(fmt::format("ES3 Spread {}", B)) { es3.spread(c, p, b, y, xm); };  
   BENCHMARK(fmt::format("ES3 Gather {}", B)) { es3.gather(c, p, b, x, ym); };
 
-  BENCHMARK(fmt::format("ES5 Spread {}", B)) { es5.spread(c, p, b, y, x); };
+  BENCHMARK(fmt::format("ES5 Spread {}", B)) { es5.spread(c, p, b, y, xm); };
   BENCHMARK(fmt::format("ES5 Gather {}", B)) { es5.gather(c, p, b, x, ym); };
+
+  Kernel<Cx, 3, Tabulated<ExpSemi<5>>> es5t(2.f);
+  BENCHMARK(fmt::format("ES5 LUT Spread {}", B)) { es5t.spread(c, p, b, y, xm); };
+  BENCHMARK(fmt::format("ES5 LUT Gather {}", B)) { es5t.gather(c, p, b, x, ym); };
+
+  std::vector<float> w(es5.PadWidth * es5.PadWidth * es5.PadWidth);
+  es5.weights(p, w.data());
+  BENCHMARK(fmt::format("ES5 Table Spread {}", B)) { es5.spread(c, w.data(), b, y, xm); };
+  BENCHMARK(fmt::format("ES5 Table Gather {}", B)) { es5.gather(c, w.data(), b, x, ym); };
+}
+
+TEMPLATE_TEST_CASE("Kernel Throughput", "[kernels]", (ExpSemi<3>), (ExpSemi<5>), (KaiserBessel<7>))
+{
+  Log::SetLevel(Log::Level::Testing);
+  Kernel<Cx, 3, TestType> kernel(2.f);
+  Index const             C = GENERATE(8, 32, 64);
+  Index const             W = kernel.paddedWidth();
+  Index const             N = 1024;
+  Cx5                     x(1, C, 16 + W, 16 + W, 16 + W);
+  Cx5Map                  xs(x.data(), x.dimensions());
+  Cx5CMap                 xm(x.data(), x.dimensions());
+  Cx1                     y(C);
+  Cx1Map                  ym(y.data(), Sz1{C});
+  x.setRandom();
+  y.setRandom();
+  std::vector<typename Kernel<Cx, 3, TestType>::Point> ps(N);
+  std::vector<std::array<int16_t, 3>>                  cs(N);
+  for (Index ii = 0; ii < N; ii++) {
+    ps[ii] = Kernel<Cx, 3, TestType>::Point::Random() * 0.5f;
+    cs[ii] = {(int16_t)(W / 2 + ii % 16), (int16_t)(W / 2 + (ii / 16) % 16), (int16_t)(W / 2 + ii / 256)};
+  }
+
+  auto const name = fmt::format("W{} C{}", TestType::Width, C);
+  auto const spread = [&]() {
+    for (Index ii = 0; ii < N; ii++) {
+      kernel.spread(cs[ii], ps[ii], y, xs);
+    }
+  };
+  auto const gather = [&]() {
+    for (Index ii = 0; ii < N; ii++) {
+      kernel.gather(cs[ii], ps[ii], xm, ym);
+    }
+  };
+  BENCHMARK(fmt::format("{} Spread {} samples", name, N)) { spread(); };
+  BENCHMARK(fmt::format("{} Gather {} samples", name, N)) { gather(); };
 }
@@ -0,0 +1,50 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include "algo/decomp.hpp"
+#include "log.hpp"
+#include "prox/llr.hpp"
+#include "tensors.hpp"
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+using namespace rl;
+
+Index const M = 64;
+Index const B = 8;
+
+TEST_CASE("LLR", "[llr]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const patch = GENERATE(3, 4, 5, 6, 7, 8);
+  Sz5 const   shape{B, M, M, M, 1};
+  Cx5         x(shape), z(shape);
+  x.setRandom();
+  Proxs::LLR       llr(1.f, patch, patch, true, shape);
+  llr.seed = 1;
+  Proxs::LLR::CMap xv(x.data(), x.size());
+  Proxs::LLR::Map  zv(z.data(), z.size());
+  BENCHMARK(fmt::format("Patch {}", patch)) { llr.apply(1.f, xv, zv); };
+}
+
+TEST_CASE("SVDShrink", "[llr]")
+{
+  Index const      patch = GENERATE(3, 4, 5, 6, 7, 8);
+  Index const      K = patch * patch * patch;
+  Eigen::MatrixXcf A(B, K);
+  A.setRandom();
+  SVDShrink shrink(B, K);
+  BENCHMARK(fmt::format("SVD {}", patch))
+  {
+    auto const            svd = SVD<Cx>(A.transpose());
+    Eigen::VectorXf const s = (svd.S > 1.f).select(svd.S - 1.f, 0.f);
+    return Eigen::MatrixXcf((svd.U * s.asDiagonal() * svd.V.adjoint()).transpose());
+  };
+  BENCHMARK(fmt::format("Gram {}", patch))
+  {
+    Eigen::MatrixXcf Ap = A;
+    shrink.apply(1.f, Ap);
+    return Ap;
+  };
+}
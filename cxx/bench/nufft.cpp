@@ -1,12 +1,14 @@
 #define CATCH_CONFIG_ENABLE_BENCHMARKING
 
 #include "op/nufft.hpp"
+#include "fft.hpp"
 #include "info.hpp"
 #include "log.hpp"
 #include "traj_spirals.hpp"
 
 #include <catch2/benchmark/catch_benchmark_all.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 using namespace rl;
 
@@ -56,3 +58,37 @@ TEST_CASE("NUFFT Basis", "[nufft]")
   BENCHMARK("adjoint") { nufft.adjoint(cnc, mc); };
   BENCHMARK("iadjoint") { nufft.iadjoint(cnc, mc); };
 }
+
+TEST_CASE("NUFFT Batches", "[nufft]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const    nBatch = GENERATE(1, 2, 4);
+  TOps::NUFFT<3> nufft(traj, "ES3", os, C, &basis, Sz3(), 32, nBatch);
+  Cx5            c(nufft.ishape);
+  Cx3            nc(nufft.oshape);
+  c.setRandom();
+  nc.setRandom();
+  Cx5Map  mc(c.data(), c.dimensions());
+  Cx3Map  mnc(nc.data(), nc.dimensions());
+  Cx5CMap cc(c.data(), c.dimensions());
+  Cx3CMap cnc(nc.data(), nc.dimensions());
+  BENCHMARK(fmt::format("forward batches {}", nBatch)) { nufft.forward(cc, mnc); };
+  BENCHMARK(fmt::format("adjoint batches {}", nBatch)) { nufft.adjoint(cnc, mc); };
+}
+
+TEST_CASE("NUFFT FFT", "[nufft]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const     N = 2 * M;
+  auto const      ph = FFT::PhaseShift(Sz3{N, N, N});
+  FFT::Plan const plan(Sz5{1, C, N, N, N}, Sz3{2, 3, 4}, Sz3{M / 2, M / 2, M / 2}, Sz3{M, M, M});
+  Cx5             grid(1, C, N, N, N);
+  grid.setRandom();
+  Cx5Map mg(grid.data(), grid.dimensions());
+  BENCHMARK("Forward") { FFT::Forward(grid, Sz3{2, 3, 4}, ph); };
+  BENCHMARK("Plan Forward") { plan.forward(mg); };
+  BENCHMARK("Plan ForwardPruned") { plan.forwardPruned(mg); };
+  BENCHMARK("Adjoint") { FFT::Adjoint(grid, Sz3{2, 3, 4}, ph); };
+  BENCHMARK("Plan Adjoint") { plan.adjoint(mg); };
+  BENCHMARK("Plan AdjointPruned") { plan.adjointPruned(mg); };
+}
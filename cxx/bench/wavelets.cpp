@@ -0,0 +1,39 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include "log.hpp"
+#include "op/wavelets.hpp"
+#include "prox/l1-wavelets.hpp"
+
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+using namespace rl;
+
+Index const M = 256;
+
+TEST_CASE("Wavelets", "[wavelets]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const       W = GENERATE(4, 6, 8);
+  Sz5 const         shape{1, M, M, M, 1};
+  TOps::Wavelets<5> wave(shape, W, {1, 2, 3});
+  Cx5               x(shape), y(shape);
+  x.setRandom();
+  Cx5CMap xm(x.data(), shape);
+  Cx5Map  ym(y.data(), shape);
+  BENCHMARK(fmt::format("forward {}", W)) { wave.forward(xm, ym); };
+  BENCHMARK(fmt::format("adjoint {}", W)) { wave.adjoint(xm, ym); };
+}
+
+TEST_CASE("L1Wavelets", "[wavelets]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Sz5 const         shape{1, M, M, M, 1};
+  Proxs::L1Wavelets prox(1.f, shape, 6, {1, 2, 3});
+  Cx5               x(shape), z(shape);
+  x.setRandom();
+  Proxs::L1Wavelets::CMap xv(x.data(), x.size());
+  Proxs::L1Wavelets::Map  zv(z.data(), z.size());
+  BENCHMARK("apply") { prox.apply(1.f, xv, zv); };
+}
@@ -1,7 +1,9 @@
 #include "inputs.hpp"
 #include "basis/basis.hpp"
+#include "cache.hpp"
 #include "io/hd5.hpp"
 #include "log.hpp"
+#include "profile.hpp"
 #include "tensors.hpp"
 #include "threads.hpp"
 
@@ -39,6 +41,7 @@ LsqOpts::LsqOpts(args::Subparser &parser)
   , btol(parser, "B", "Tolerance on b (1e-6)", {"btol"}, 1.e-6f)
   , ctol(parser, "C", "Tolerance on cond(A) (1e-6)", {"ctol"}, 1.e-6f)
   , λ(parser, "λ", "Tikhonov parameter (default 0)", {"lambda"}, 0.f)
+  , toeplitz(parser, "T", "Solve the normal equations with CG and a Toeplitz-embedded NUFFT", {"toeplitz"})
 {
 }
 
@@ -54,6 +57,8 @@ RlsqOpts::RlsqOpts(args::Subparser &parser)
   , ε(parser, "ε", "ADMM convergence tolerance (1e-2)", {"eps"}, 1.e-2f)
   , μ(parser, "μ", "ADMM residual rescaling tolerance (default 1.2)", {"mu"}, 1.2f)
   , τ(parser, "τ", "ADMM residual rescaling maximum (default 10)", {"tau"}, 10.f)
+  , checkEvery(parser, "K", "Check ADMM convergence every K iterations (default 1)", {"check-every"}, 1)
+  , toeplitz(parser, "T", "Solve the inner problem with CG and a Toeplitz-embedded NUFFT", {"toeplitz"})
 {
 }
 
@@ -63,6 +68,10 @@ args::MapFlag<int, Log::Level>
                              verbosity(global_group, "V", "Log level 0-3", {'v', "verbosity"}, levelMap, Log::Level::Standard);
 args::ValueFlag<std::string> debug(global_group, "F", "Write debug images to file", {"debug"});
 args::ValueFlag<Index>       nthreads(global_group, "N", "Limit number of threads", {"nthreads"});
+args::ValueFlag<std::string> cacheDir(global_group, "D", "Cache mappings and preconditioners in directory", {"cache"});
+args::ValueFlag<Index>       cacheSize(global_group, "MB", "Evict oldest cache entries above this size (0 = unlimited)", {"cache-size"});
+args::Flag                   profile(global_group, "P", "Profile operators and print a summary", {"profile"});
+args::ValueFlag<std::string> trace(global_group, "F", "Profile operators and write a Chrome trace to file", {"trace"});
 
 void SetLogging(std::string const &name)
 {
@@ -88,11 +97,36 @@ void SetThreadCount()
   Log::Print("Using {} threads", Threads::GlobalThreadCount());
 }
 
+void SetCache()
+{
+  if (cacheDir) {
+    Cache::SetDirectory(cacheDir.Get());
+  } else if (char *const env_p = std::getenv("RL_CACHE")) {
+    Cache::SetDirectory(env_p);
+  }
+  if (cacheSize) {
+    Cache::SetBudget(cacheSize.Get());
+  } else if (char *const env_p = std::getenv("RL_CACHE_SIZE")) {
+    Cache::SetBudget(std::atol(env_p));
+  }
+}
+
+void SetProfile()
+{
+  if (trace) {
+    Profile::Enable(trace.Get());
+  } else if (profile || std::getenv("RL_PROFILE")) {
+    Profile::Enable();
+  }
+}
+
 void ParseCommand(args::Subparser &parser)
 {
   parser.Parse();
   SetLogging(parser.GetCommand().Name());
   SetThreadCount();
+  SetCache();
+  SetProfile();
 }
 
 void ParseCommand(args::Subparser &parser, args::Positional<std::string> &iname)
@@ -41,6 +41,7 @@ struct LsqOpts
   args::ValueFlag<float> btol;
   args::ValueFlag<float> ctol;
   args::ValueFlag<float> λ;
+  args::Flag             toeplitz;
 };
 
 struct RlsqOpts
@@ -59,4 +60,6 @@ struct RlsqOpts
   args::ValueFlag<float> ε;
   args::ValueFlag<float> μ;
   args::ValueFlag<float> τ;
+  args::ValueFlag<Index> checkEvery;
+  args::Flag             toeplitz;
 };
@@ -1,5 +1,7 @@
+#include "arena.hpp"
 #include "log.hpp"
 #include "inputs.hpp"
+#include "profile.hpp"
 
 using namespace rl;
 
@@ -77,6 +79,10 @@ int main(int const argc, char const *const argv[])
   args::GlobalOptions globals(parser, global_group);
   try {
     parser.ParseCLI(argc, argv);
+    Profile::Finish();
+    if (Arena::Peak() > 0) {
+      Log::Print("Operator scratch peak {} MB", Arena::Peak() / (1024 * 1024));
+    }
     Log::End();
   } catch (args::Help &) {
     fmt::print(stderr, "{}\n", parser.Help());
@@ -17,8 +17,8 @@ auto MakeGrid(GridOpts &gridOpts, Trajectory const &traj, Index const nC, Index
   -> TOps::TOp<Cx, 6, 5>::Ptr
 {
   if (gridOpts.vcc) {
-    auto grid =
-      TOps::Grid<3, true>::Make(traj, gridOpts.ktype.Get(), gridOpts.osamp.Get(), nC, basis, gridOpts.subgridSize.Get());
+    auto grid = TOps::Grid<3, true>::Make(traj, gridOpts.ktype.Get(), gridOpts.osamp.Get(), nC, basis,
+                                          gridOpts.subgridSize.Get(), gridOpts.kTable.Get());
     auto const ns = grid->ishape;
     auto       reshape =
       std::make_shared<TOps::ReshapeInput<TOps::Grid<3, true>, 5>>(grid, Sz5{ns[0] * ns[1], ns[2], ns[3], ns[4], ns[5]});
@@ -28,8 +28,8 @@ auto MakeGrid(GridOpts &gridOpts, Trajectory const &traj, Index const nC, Index
     auto timeLoop = TOps::MakeLoop(slabLoop, nT);
     return timeLoop;
   } else {
-    auto grid =
-      TOps::Grid<3, false>::Make(traj, gridOpts.ktype.Get(), gridOpts.osamp.Get(), nC, basis, gridOpts.subgridSize.Get());
+    auto grid = TOps::Grid<3, false>::Make(traj, gridOpts.ktype.Get(), gridOpts.osamp.Get(), nC, basis,
+                                          gridOpts.subgridSize.Get(), gridOpts.kTable.Get());
     auto loop = TOps::MakeLoop(grid, nSlab);
     auto slabToVol = std::make_shared<TOps::Multiplex<Cx, 5>>(grid->ishape, nSlab);
     auto compose1 = TOps::MakeCompose(slabToVol, loop);
@@ -25,6 +25,7 @@ void main_prox(args::Subparser &parser)
   args::ValueFlag<Index> llrPatch(parser, "SZ", "Patch size for LLR (default 4)", {"llr-patch"}, 5);
   args::ValueFlag<Index> llrWin(parser, "SZ", "Patch size for LLR (default 4)", {"llr-win"}, 3);
   args::Flag             llrShift(parser, "S", "Enable random LLR shifting", {"llr-shift"});
+  args::ValueFlag<Index> llrSeed(parser, "N", "Seed for the LLR shifts, for reproducible results", {"llr-seed"});
 
   args::ValueFlag<float> wavelets(parser, "L", "L1 Wavelet denoising", {"wavelets"});
   VectorFlag<Index>      waveDims(parser, "W", "Wavelet denoising levels", {"wavelet-dims"}, std::vector<Index>{1, 2, 3});
@@ -48,7 +49,9 @@ void main_prox(args::Subparser &parser)
   if (wavelets) {
     prox = std::make_shared<Proxs::L1Wavelets>(wavelets.Get(), shape, waveWidth.Get(), waveDims.Get());
   } else if (llr) {
-    prox = std::make_shared<Proxs::LLR>(llr.Get(), llrPatch.Get(), llrWin.Get(), llrShift, shape);
+    auto p = std::make_shared<Proxs::LLR>(llr.Get(), llrPatch.Get(), llrWin.Get(), llrShift, shape);
+    if (llrSeed) { p->seed = llrSeed.Get(); }
+    prox = p;
   } else if (l1) {
     prox = std::make_shared<Proxs::L1>(l1.Get(), nvox);
   } else if (nmrent) {
@@ -1,5 +1,6 @@
 #include "types.hpp"
 
+#include "algo/cg.hpp"
 #include "algo/lsmr.hpp"
 #include "inputs.hpp"
 #include "log.hpp"
@@ -31,15 +32,34 @@ void main_recon_lsq(args::Subparser &parser)
   Index const nT = noncart.dimension(4);
 
   auto const basis = LoadBasis(coreOpts.basisFile.Get());
-  auto const A = Recon::SENSE(coreOpts.ndft, gridOpts, senseOpts, traj, nS, nT, basis.get(), noncart);
+  auto const maps = SENSE::Choose(senseOpts, gridOpts, traj, noncart);
+  auto const A = Recon::SENSE(coreOpts.ndft, gridOpts, maps, traj, nS, nT, basis.get());
   auto const M = MakeKspacePre(traj, nC, nT, basis.get(), preOpts.type.Get(), preOpts.bias.Get(), coreOpts.ndft.Get());
   Log::Debug("A {} {} M {} {}", A->ishape, A->oshape, M->rows(), M->cols());
-  auto debug = [shape = A->ishape](Index const i, LSMR::Vector const &x) {
-    Log::Tensor(fmt::format("lsmr-x-{:02d}", i), shape, x.data(), HD5::Dims::Image);
-  };
-  LSMR lsmr{A, M, lsqOpts.its.Get(), lsqOpts.atol.Get(), lsqOpts.btol.Get(), lsqOpts.ctol.Get(), debug};
 
-  auto const x = lsmr.run(CollapseToConstVector(noncart), lsqOpts.λ.Get());
+  LSMR::Vector x;
+  if (lsqOpts.toeplitz) {
+    if (coreOpts.ndft) { Log::Fail("Toeplitz embedding is not supported with the NDFT"); }
+    // Solve (A'M⁻¹A + λ²I)x = A'M⁻¹b, which is what LSMR minimises
+    auto const   W = KSpaceWeights(traj, basis.get(), preOpts.type.Get(), preOpts.bias.Get());
+    Ops::Op<Cx>::Ptr N = Recon::SENSENormal(gridOpts, maps, traj, nS, nT, basis.get(), W);
+    if (lsqOpts.λ.Get() > 0.f) {
+      float const λ = lsqOpts.λ.Get();
+      N = std::make_shared<Ops::Add<Cx>>(N, std::make_shared<Ops::DiagScale<Cx>>(N->cols(), λ * λ));
+    }
+    LSMR::Vector Mb(A->rows());
+    LSMR::Map    Mbm(Mb.data(), Mb.size());
+    M->inverse(CollapseToConstVector(noncart), Mbm);
+    LSMR::Vector           AʹMb = A->adjoint(Mb);
+    ConjugateGradients<Cx> cg{N, lsqOpts.its.Get(), lsqOpts.atol.Get()};
+    x = cg.run(AʹMb.data());
+  } else {
+    auto debug = [shape = A->ishape](Index const i, LSMR::Vector const &x) {
+      Log::Tensor(fmt::format("lsmr-x-{:02d}", i), shape, x.data(), HD5::Dims::Image);
+    };
+    LSMR lsmr{A, M, lsqOpts.its.Get(), lsqOpts.atol.Get(), lsqOpts.btol.Get(), lsqOpts.ctol.Get(), debug};
+    x = lsmr.run(CollapseToConstVector(noncart), lsqOpts.λ.Get());
+  }
   auto const xm = Tensorfy(x, A->ishape);
 
   TOps::Crop<Cx, 5> oc(A->ishape, traj.matrixForFOV(coreOpts.fov.Get(), A->ishape[0], nT));
@@ -35,7 +35,8 @@ void main_recon_rlsq(args::Subparser &parser)
   Index const nT = noncart.dimension(4);
 
   auto const basis = LoadBasis(coreOpts.basisFile.Get());
-  auto const recon = Recon::SENSE(coreOpts.ndft, gridOpts, senseOpts, traj, nS, nT, basis.get(), noncart);
+  auto const maps = SENSE::Choose(senseOpts, gridOpts, traj, noncart);
+  auto const recon = Recon::SENSE(coreOpts.ndft, gridOpts, maps, traj, nS, nT, basis.get());
   auto const shape = recon->ishape;
   auto const M = MakeKspacePre(traj, nC, nT, basis.get(), preOpts.type.Get(), preOpts.bias.Get());
 
@@ -74,6 +75,13 @@ void main_recon_rlsq(args::Subparser &parser)
            rlsqOpts.τ.Get(),
            debug_x,
            debug_z};
+  opt.checkEvery = rlsqOpts.checkEvery.Get();
+  if (rlsqOpts.toeplitz) {
+    if (coreOpts.ndft) { Log::Fail("Toeplitz embedding is not supported with the NDFT"); }
+    if (ext_x->rows() != ext_x->cols()) { Log::Fail("Toeplitz embedding is not supported with TGV"); }
+    auto const W = KSpaceWeights(traj, basis.get(), preOpts.type.Get(), preOpts.bias.Get());
+    opt.N = Recon::SENSENormal(gridOpts, maps, traj, nS, nT, basis.get(), W);
+  }
 
   auto const x = ext_x->forward(opt.run(CollapseToConstVector(noncart), rlsqOpts.ρ.Get()));
   auto const xm = Tensorfy(x, recon->ishape);
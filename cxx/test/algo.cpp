@@ -1,3 +1,4 @@
+#include "algo/blas.hpp"
 #include "algo/lsmr.hpp"
 #include "op/ops.hpp"
 #include <catch2/catch_approx.hpp>
@@ -23,4 +24,27 @@ TEST_CASE("Algorithms", "[alg]")
     INFO("x " << x.transpose() << "\ny " << y.transpose() << "\nxx " << xx.transpose());
     CHECK((x - xx).stableNorm() == Approx(0.f).margin(1.e-3f));
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("BLAS", "[alg]")
+{
+  Index const      N = GENERATE(7, 100000);
+  Eigen::VectorXcf x = Eigen::VectorXcf::Random(N);
+  Eigen::VectorXcf y = Eigen::VectorXcf::Random(N);
+  float const      a = 0.5f;
+  INFO("N " << N);
+  CHECK(std::abs(BLAS::Dot(x, y) - x.dot(y)) == Approx(0.f).margin(1.e-4f * N));
+  CHECK(BLAS::SquaredNorm(x) == Approx(x.squaredNorm()).epsilon(1.e-5f));
+  CHECK(BLAS::Norm(x) == Approx(x.stableNorm()).epsilon(1.e-5f));
+
+  Eigen::VectorXcf const axpy = y + a * x;
+  Eigen::VectorXcf       z = y;
+  BLAS::Axpy(a, x, z);
+  CHECK((z - axpy).stableNorm() == Approx(0.f).margin(1.e-5f));
+  z = y;
+  CHECK(BLAS::AxpyNorm(a, x, z) == Approx(axpy.squaredNorm()).epsilon(1.e-5f));
+  CHECK((z - axpy).stableNorm() == Approx(0.f).margin(1.e-5f));
+  z = y;
+  BLAS::Xpby(x, a, z);
+  CHECK((z - (x + a * y)).stableNorm() == Approx(0.f).margin(1.e-5f));
+}
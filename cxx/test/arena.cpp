@@ -0,0 +1,43 @@
+#include "arena.hpp"
+#include "log.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+using namespace rl;
+
+TEST_CASE("Arena", "[arena]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  std::vector<std::pair<Cx *, Cx *>> ptrs;
+  Index                              peak1 = 0, peak2 = 0;
+  bool                               intact = true;
+  // Use a fresh thread so the arena starts empty. Catch assertions are only made on the main thread.
+  std::thread t([&] {
+    for (Index ii = 0; ii < 3; ii++) {
+      Arena::Lease outer(100 * sizeof(Cx));
+      outer.data<Cx>()[99] = Cx(2.f);
+      {
+        Arena::Lease inner(1 << 20);
+        ptrs.emplace_back(outer.data<Cx>(), inner.data<Cx>());
+        inner.data<Cx>()[0] = Cx(1.f);
+      }
+      intact = intact && (outer.data<Cx>()[99] == Cx(2.f));
+    }
+    peak1 = Arena::Peak();
+    Arena::Lease outer(100 * sizeof(Cx));
+    Arena::Lease inner(1 << 20);
+    peak2 = Arena::Peak();
+  });
+  t.join();
+  CHECK(intact);
+  for (auto const &p : ptrs) {
+    CHECK(reinterpret_cast<uintptr_t>(p.first) % 64 == 0);
+    CHECK(reinterpret_cast<uintptr_t>(p.second) % 64 == 0);
+    CHECK(p.second >= p.first + 100);
+  }
+  // After the first application the blocks are merged and the same memory is reused
+  CHECK(ptrs[1] == ptrs[2]);
+  CHECK(peak2 == peak1);
+}
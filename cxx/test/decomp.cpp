@@ -3,6 +3,7 @@
 #include "tensors.hpp"
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <fmt/ostream.h>
 
 using namespace rl;
@@ -21,4 +22,20 @@ TEST_CASE("decomp")
     auto cov = Covariance(data);
     Eig<Cx> eig(cov);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("SVDShrink")
+{
+  Index const rows = GENERATE(4, 8, 40);
+  Index const cols = 27;
+  Eigen::MatrixXcf A(rows, cols);
+  A.setRandom();
+  SVD<Cx> const   svd(A);
+  float const     λ = svd.S(std::min(rows, cols) / 2);
+  Eigen::VectorXf const s = (svd.S > λ).select(svd.S - λ, 0.f);
+  Eigen::MatrixXcf const ref = svd.U * s.asDiagonal() * svd.V.adjoint();
+  SVDShrink shrink(rows, cols);
+  shrink.apply(λ, A);
+  INFO("rows " << rows);
+  CHECK((A - ref).norm() == Approx(0.f).margin(1.e-4f * ref.norm()));
+}
@@ -88,3 +88,21 @@ TEMPLATE_TEST_CASE(
   CHECK(k1(0, 0, 0) == Approx(0.f).margin(1.e-9));
   CHECK(k1(1, 1, 1) == Approx(k1(TestType::PadWidth - 1, TestType::PadWidth - 1, TestType::PadWidth - 1)).margin(1.e-5));
 }
+
+TEMPLATE_TEST_CASE(
+  "3D-Tabulated",
+  "[kernels]",
+  (rl::ExpSemi<3>),
+  (rl::ExpSemi<5>),
+  (rl::KaiserBessel<5>))
+{
+  rl::Kernel<float, 3, TestType>                kernel(2.f);
+  rl::Kernel<float, 3, rl::Tabulated<TestType>> table(2.f);
+  typename rl::Kernel<float, 3, TestType>::Point p;
+  p.setConstant(0.3f);
+  p[2] = -0.2f;
+  rl::Re3 const k = kernel(p);
+  rl::Re3 const t = table(p);
+  INFO(k << "\n" << t);
+  CHECK(rl::Norm(rl::Re3(k - t)) == Approx(0.f).margin(1.e-4));
+}
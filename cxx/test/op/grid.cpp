@@ -1,9 +1,14 @@
 #include "op/grid.hpp"
+#include "arena.hpp"
+#include "cache.hpp"
 #include "log.hpp"
 #include "tensors.hpp"
+#include "traj_spirals.hpp"
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <filesystem>
+#include <limits>
 #include <numbers>
 
 using namespace rl;
@@ -128,4 +133,226 @@ TEST_CASE("Grid VCC", "[grid]")
     CHECK(noncart(0, ii, 0).real() == Approx(0.f).margin(1e-6f));
     CHECK(noncart(0, ii, 0).imag() == Approx(1.f).margin(1e-6f));
   }
-}
\ No newline at end of file
+}
+TEST_CASE("Grid Mapping", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const M = 16;
+  Re3         points = ArchimedeanSpiral(M, 1.f, M * M);
+  points(0, 3, 7) = std::numeric_limits<float>::quiet_NaN();
+  Trajectory const traj(points, Sz3{M, M, M});
+  Threads::SetGlobalThreadCount(1);
+  auto const serial = CalcMapping(traj, 2.f, 6, 8);
+  Threads::SetGlobalThreadCount(5);
+  auto const parallel = CalcMapping(traj, 2.f, 6, 8);
+  Threads::SetGlobalThreadCount(0);
+
+  auto const &pm = parallel.mappings;
+  auto const &sm = serial.mappings;
+  CHECK(pm.size() == points.dimension(1) * points.dimension(2) - 1);
+  REQUIRE(sm.size() == pm.size());
+  Index different = 0;
+  for (size_t ii = 0; ii < pm.size(); ii++) {
+    if (pm[ii].sample != sm[ii].sample || pm[ii].trace != sm[ii].trace) { different++; }
+  }
+  CHECK(different == 0);
+
+  // Runs must tile the mappings in subgrid order, with each run sorted on the cartesian location
+  auto sgKey = [](SubgridRun<3> const &r) { return std::make_tuple(r.subgrid[2], r.subgrid[1], r.subgrid[0]); };
+  auto key = [](Mapping<3> const &m) { return std::make_tuple(m.cart[2], m.cart[1], m.cart[0]); };
+  Index next = 0, unsorted = 0;
+  for (size_t ir = 0; ir < parallel.subgrids.size(); ir++) {
+    auto const &run = parallel.subgrids[ir];
+    CHECK(run.start == next);
+    CHECK(run.size > 0);
+    if (ir > 0 && !(sgKey(parallel.subgrids[ir - 1]) < sgKey(run))) { unsorted++; }
+    for (Index im = run.start + 1; im < run.start + run.size; im++) {
+      if (key(pm[im]) < key(pm[im - 1])) { unsorted++; }
+    }
+    next += run.size;
+  }
+  CHECK(next == (Index)pm.size());
+  CHECK(unsorted == 0);
+}
+
+TEST_CASE("Grid Mapping Cache", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  auto const       dir = std::filesystem::temp_directory_path() / "riesling-test-cache";
+  Index const      M = 16;
+  Trajectory const traj(ArchimedeanSpiral(M, 1.f, M * M));
+  std::filesystem::remove_all(dir);
+  Cache::SetDirectory(dir.string());
+  auto const first = CachedMapping(traj, 2.f, 6, 8);
+  CHECK(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()) == 1);
+  auto const second = CachedMapping(traj, 2.f, 6, 8);
+  Cache::SetDirectory("");
+  std::filesystem::remove_all(dir);
+
+  auto const ref = CalcMapping(traj, 2.f, 6, 8);
+  CHECK(second.cartDims == ref.cartDims);
+  CHECK(second.noncartDims == ref.noncartDims);
+  REQUIRE(second.mappings.size() == ref.mappings.size());
+  REQUIRE(second.subgrids.size() == ref.subgrids.size());
+  Index different = 0;
+  for (size_t ii = 0; ii < ref.mappings.size(); ii++) {
+    auto const &a = second.mappings[ii];
+    auto const &b = ref.mappings[ii];
+    if (a.cart != b.cart || a.sample != b.sample || a.trace != b.trace || (a.offset != b.offset).any()) { different++; }
+  }
+  for (size_t ii = 0; ii < ref.subgrids.size(); ii++) {
+    auto const &a = second.subgrids[ii];
+    auto const &b = ref.subgrids[ii];
+    if (a.subgrid != b.subgrid || a.start != b.start || a.size != b.size) { different++; }
+  }
+  CHECK(different == 0);
+}
+
+TEST_CASE("Grid Autotune", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  auto const       dir = std::filesystem::temp_directory_path() / "riesling-test-cache";
+  Index const      M = 16;
+  Trajectory const traj(ArchimedeanSpiral(M, 1.f, M * M));
+  Basis            basis;
+  std::filesystem::remove_all(dir);
+  Cache::SetDirectory(dir.string());
+  auto const tuned = TOps::Grid<3, false>::Make(traj, "ES5", 2.f, 2, &basis, TOps::Grid<3, false>::Autotune);
+  CHECK(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()) == 2);
+  auto const cached = TOps::Grid<3, false>::Make(traj, "ES5", 2.f, 2, &basis, TOps::Grid<3, false>::Autotune);
+  Cache::SetDirectory("");
+  std::filesystem::remove_all(dir);
+  CHECK(cached->subgridSize == tuned->subgridSize);
+  CHECK(cached->chunks == tuned->chunks);
+  CHECK(tuned->subgridSize > 0);
+
+  auto const ref = TOps::Grid<3, false>::Make(traj, "ES5", 2.f, 2, &basis);
+  Cx3        noncart(ref->oshape);
+  noncart.setRandom();
+  Cx5 const a = ref->adjoint(noncart);
+  Cx5 const b = tuned->adjoint(noncart);
+  CHECK(Norm(b - a) == Approx(0.f).margin(1e-4f * Norm(a)));
+}
+
+TEST_CASE("Grid Colours", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Threads::SetGlobalThreadCount(4);
+  Index const      M = GENERATE(15, 16);
+  Index const      sgW = GENERATE(4, 5, 8, 32);
+  Trajectory const traj(ArchimedeanSpiral(M, 1.f, M * M));
+  Basis            basis;
+  auto             grid = TOps::Grid<3, false>::Make(traj, "ES5", 2.f, 2, &basis, sgW);
+  Cx3              noncart(grid->oshape);
+  noncart.setRandom();
+  grid->coloured = false;
+  Cx5 const locked = grid->adjoint(noncart);
+  grid->coloured = true;
+  Cx5 const coloured = grid->adjoint(noncart);
+  INFO("M " << M << " subgrid " << sgW << " colours " << grid->colours.size());
+  CHECK(Norm(coloured - locked) == Approx(0.f).margin(1e-4f * Norm(locked)));
+
+  /* Every point of the periodic grid, halos included, is written by at most one subgrid of each colour */
+  Sz3 const cartDims = LastN<3>(grid->ishape);
+  Index     overlaps = 0;
+  for (auto const &colour : grid->colours) {
+    Eigen::Tensor<int, 3> hits(cartDims);
+    hits.setZero();
+    for (auto const &run : colour) {
+      for (Index iz = 0; iz < grid->subgridW; iz++) {
+        for (Index iy = 0; iy < grid->subgridW; iy++) {
+          for (Index ix = 0; ix < grid->subgridW; ix++) {
+            Sz3 const ind{ix, iy, iz};
+            Sz3       w;
+            for (Index id = 0; id < 3; id++) {
+              w[id] = ((run.subgrid[id] + ind[id]) % cartDims[id] + cartDims[id]) % cartDims[id];
+            }
+            if (++hits(w) > 1) { overlaps++; }
+          }
+        }
+      }
+    }
+  }
+  CHECK(overlaps == 0);
+  Threads::SetGlobalThreadCount(0);
+}
+
+TEST_CASE("Grid Basis Fused", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Threads::SetGlobalThreadCount(4);
+  Index const      M = 16;
+  Index const      nB = GENERATE(2, 4, 8);
+  Trajectory const traj(ArchimedeanSpiral(M, 1.f, M * M));
+  Basis            basis(nB, 1, 16);
+  basis.B.setRandom();
+  auto grid = TOps::Grid<3, false>::Make(traj, "ES5", 2.f, 2, &basis, 8);
+  Cx3  noncart(grid->oshape);
+  noncart.setRandom();
+  Cx5 cart(grid->ishape);
+  cart.setRandom();
+  grid->fused = false;
+  Cx5 const x = grid->adjoint(noncart);
+  Cx3 const y = grid->forward(cart);
+  grid->fused = true;
+  INFO("nB " << nB);
+  CHECK(Norm(grid->adjoint(noncart) - x) == Approx(0.f).margin(1e-4f * Norm(x)));
+  CHECK(Norm(grid->forward(cart) - y) == Approx(0.f).margin(1e-4f * Norm(y)));
+  Threads::SetGlobalThreadCount(0);
+}
+
+TEST_CASE("Grid Kernel Table", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const      M = 16;
+  Trajectory const traj(ArchimedeanSpiral(M, 1.f, M * M));
+  Basis            basis;
+  auto             grid = TOps::Grid<3, false>::Make(traj, "ES5", 2.f, 2, &basis, 8);
+  auto             table = TOps::Grid<3, false>::Make(traj, "ES5", 2.f, 2, &basis, 8, 16);
+  auto             lut = TOps::Grid<3, false>::Make(traj, "ES5", 2.f, 2, &basis, 8, 1);
+  CHECK(grid->weights.empty());
+  CHECK(!table->weights.empty());
+  CHECK(lut->weights.empty());
+
+  Cx3 noncart(grid->oshape);
+  noncart.setRandom();
+  Cx5 const ref = grid->adjoint(noncart);
+  CHECK(Norm(table->adjoint(noncart) - ref) == Approx(0.f).margin(1e-5f * Norm(ref)));
+  CHECK(Norm(lut->adjoint(noncart) - ref) == Approx(0.f).margin(1e-3f * Norm(ref)));
+
+  Cx5 cart(grid->ishape);
+  cart.setRandom();
+  Cx3 const nc = grid->forward(cart);
+  CHECK(Norm(table->forward(cart) - nc) == Approx(0.f).margin(1e-5f * Norm(nc)));
+  CHECK(Norm(lut->forward(cart) - nc) == Approx(0.f).margin(1e-3f * Norm(nc)));
+}
+
+TEST_CASE("Grid Scratch", "[grid]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Threads::SetGlobalThreadCount(2);
+  Index const M = 16;
+  Basis       basis(4, M / 2, 1);
+  basis.B.setRandom();
+  auto const apply = [&](TOps::Grid<3, false> const &grid) {
+    Cx3    noncart(grid.oshape);
+    Cx5    cart(grid.ishape);
+    Cx3Map ncm(noncart.data(), noncart.dimensions());
+    Cx5Map cm(cart.data(), cart.dimensions());
+    noncart.setRandom();
+    cart.setRandom();
+    grid.forward(cart, ncm);
+    grid.adjoint(noncart, cm);
+  };
+  /* Scratch subgrids depend on the number of threads, not the number of samples, so after the first application of
+   * either operator the arena should not need to grow */
+  auto const few = TOps::Grid<3, false>::Make(Trajectory(ArchimedeanSpiral(M, 1.f, 64)), "ES3", 2.f, 4, &basis);
+  auto const many = TOps::Grid<3, false>::Make(Trajectory(ArchimedeanSpiral(M, 1.f, 1024)), "ES3", 2.f, 4, &basis);
+  apply(*few);
+  Index const blocks = Arena::Blocks();
+  apply(*few);
+  apply(*many);
+  apply(*few);
+  CHECK(Arena::Blocks() == blocks);
+  Threads::SetGlobalThreadCount(0);
+}
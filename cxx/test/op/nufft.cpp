@@ -1,4 +1,5 @@
 #include "op/nufft.hpp"
+#include "op/nufft-normal.hpp"
 #include "basis/fourier.hpp"
 #include "log.hpp"
 #include "op/grid.hpp"
@@ -66,6 +67,13 @@ TEST_CASE("NUFFT-Basis", "[nufft]")
   img = nufft.adjoint(ks);
   ks = nufft.forward(img);
   CHECK(std::real(ks(0, 0, 0)) == Approx(1.f).margin(2.e-2f));
+
+  // Pipelined batches should match a single batch
+  TOps::NUFFT<1> nufft1(traj, "ES3", osamp, C, &basis, Sz1(), 32, 1);
+  img.setRandom();
+  ks.setRandom();
+  CHECK(Norm(nufft.forward(img) - nufft1.forward(img)) == Approx(0.f).margin(1.e-5f));
+  CHECK(Norm(nufft.adjoint(ks) - nufft1.adjoint(ks)) == Approx(0.f).margin(1.e-5f));
 }
 
 TEST_CASE("NUFFT-Batch", "[nufft]")
@@ -125,3 +133,32 @@ TEST_CASE("NUFFT-VCC", "[nufft]")
   INFO("KS\n" << ks);
   CHECK(Norm(ks) == Approx(1.f).margin(1.e-2f));
 }
+
+TEST_CASE("NUFFT-Normal", "[nufft]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const M = GENERATE(7, 8);
+  Index const S = 13;
+  auto const  matrix = Sz1{M};
+  Re3         points(1, S, 1);
+  Re2         weights(S, 1);
+  for (Index ii = 0; ii < S; ii++) {
+    points(0, ii, 0) = -0.5f * M + ii * M / (float)S;
+    weights(ii, 0) = 1.f + (ii % 3);
+  }
+  TrajectoryN<1> const  traj(points, matrix);
+  Basis                 basis;
+  Index const           C = 2;
+  TOps::NUFFT<1, false> nufft(traj, "ES5", 2.f, C, &basis);
+  TOps::NUFFTNormal<1>  normal(traj, "ES5", 2.f, C, &basis, weights);
+  CHECK(normal.ishape == nufft.ishape);
+  Cx3 img(nufft.ishape);
+  img.setRandom();
+  Cx3 ks = nufft.forward(img);
+  ks = ks * weights.reshape(Sz3{1, S, 1}).broadcast(Sz3{C, 1, 1}).cast<Cx>();
+  Cx3 const ref = nufft.adjoint(ks);
+  Cx3 const toe = normal.forward(img);
+  INFO("REF\n" << ref);
+  INFO("TOE\n" << toe);
+  CHECK(Norm(Cx3(toe - ref)) == Approx(0.f).margin(1.e-2f * Norm(ref)));
+}
@@ -1,6 +1,7 @@
 #include "op/nufft.hpp"
 #include "op/sense.hpp"
 #include "op/compose.hpp"
+#include "op/loop.hpp"
 #include "basis/basis.hpp"
 #include "log.hpp"
 #include <catch2/catch_approx.hpp>
@@ -47,3 +48,29 @@ TEST_CASE("Recon-Basic", "[recon]")
   // INFO("ks\n" << ks);
   CHECK(Norm(ks) == Approx(Norm(img)).margin(2.e-1f));
 }
+
+TEST_CASE("Recon-Loop", "[recon]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const M = 8;
+  Index const nC = 2;
+  Index const nF = 5;
+  Re3         points(1, M, 1);
+  for (Index ii = 0; ii < M; ii++) {
+    points(0, ii, 0) = -0.5f * M + ii;
+  }
+  TrajectoryN<1> const traj(points, Sz1{M});
+  Basis                basis;
+  auto                 nufft = std::make_shared<TOps::NUFFT<1>>(traj, "ES3", 2.f, nC, &basis);
+  TOps::Loop           inner(nufft, nF, TOps::LoopMode::Inner);
+  TOps::Loop           outer(nufft, nF, TOps::LoopMode::Outer);
+
+  Cx4 img(inner.ishape);
+  img.setRandom();
+  Cx4 const ksI = inner.forward(img);
+  Cx4 const ksO = outer.forward(img);
+  CHECK(Norm(ksO - ksI) == Approx(0.f).margin(1.e-6f * Norm(ksI)));
+  Cx4 const imgI = inner.adjoint(ksI);
+  Cx4 const imgO = outer.adjoint(ksI);
+  CHECK(Norm(imgO - imgI) == Approx(0.f).margin(1.e-6f * Norm(imgI)));
+}
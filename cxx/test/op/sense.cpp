@@ -1,7 +1,12 @@
+#include "op/compose.hpp"
+#include "op/nufft.hpp"
+#include "op/sense-nufft.hpp"
 #include "op/sense.hpp"
+#include "log.hpp"
 #include "tensors.hpp"
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 using namespace rl;
 using namespace Catch;
@@ -69,3 +74,62 @@ TEST_CASE("VCC-SENSE", "[SENSE]")
     CHECK(std::abs((yy - xx) / (yy + xx + 1.e-15f)) == Approx(0).margin(1.e-6));
   }
 }
+
+TEST_CASE("SENSE-NUFFT", "[SENSE]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const M = 8, nC = 4;
+  Index const nBatch = GENERATE(1, 2);
+  Re3         points(3, 16, 4);
+  points.setRandom();
+  points = points * points.constant(0.4f * M);
+  Trajectory const traj(points, Sz3{M, M, M});
+  Basis            basis;
+  Cx5              maps(1, nC, M, M, M);
+  maps.setRandom();
+
+  TOps::SENSENUFFT fused(traj, "ES3", 2.f, maps, &basis, 32, nBatch);
+  auto             sense = std::make_shared<TOps::SENSE>(maps);
+  auto             nufft = std::make_shared<TOps::NUFFT<3>>(traj, "ES3", 2.f, nC, &basis, sense->mapDimensions());
+  TOps::Compose    ref(sense, nufft);
+
+  Cx4 img(fused.ishape);
+  Cx3 ks(fused.oshape);
+  img.setRandom();
+  ks.setRandom();
+  Cx3 const ksRef = ref.forward(img);
+  Cx4 const imgRef = ref.adjoint(ks);
+  CHECK(Norm(fused.forward(img) - ksRef) == Approx(0.f).margin(1.e-5f * Norm(ksRef)));
+  CHECK(Norm(fused.adjoint(ks) - imgRef) == Approx(0.f).margin(1.e-5f * Norm(imgRef)));
+}
+
+TEST_CASE("SENSE-Precision", "[SENSE]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const M = 8, nC = 4;
+  auto const  p = GENERATE(Precision::Half, Precision::BFloat16);
+  float const tol = p == Precision::Half ? 1.e-3f : 1.e-2f;
+  Cx5         maps(1, nC, M, M, M);
+  maps.setRandom();
+  Cx4 img(1, M, M, M);
+  img.setRandom();
+
+  TOps::SENSE ref(maps);
+  TOps::SENSE compact(maps, 1, p);
+  Cx5 const   chan = ref.forward(img);
+  Cx4 const   comb = ref.adjoint(chan);
+  CHECK(Norm(compact.forward(img) - chan) == Approx(0.f).margin(tol * Norm(chan)));
+  CHECK(Norm(compact.adjoint(chan) - comb) == Approx(0.f).margin(tol * Norm(comb)));
+
+  Re3 points(3, 16, 4);
+  points.setRandom();
+  points = points * points.constant(0.4f * M);
+  Trajectory const traj(points, Sz3{M, M, M});
+  Basis            basis;
+  TOps::SENSENUFFT snRef(traj, "ES3", 2.f, maps, &basis);
+  TOps::SENSENUFFT snCompact(traj, "ES3", 2.f, maps, &basis, 32, 1, 0, p);
+  Cx3 const        ks = snRef.forward(img);
+  Cx4 const        adj = snRef.adjoint(ks);
+  CHECK(Norm(snCompact.forward(img) - ks) == Approx(0.f).margin(tol * Norm(ks)));
+  CHECK(Norm(snCompact.adjoint(ks) - adj) == Approx(0.f).margin(tol * Norm(adj)));
+}
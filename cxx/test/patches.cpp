@@ -0,0 +1,33 @@
+#include "patches.hpp"
+#include "tensors.hpp"
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+using namespace rl;
+using namespace Catch;
+
+TEST_CASE("Patches", "[patches]")
+{
+  Index const patch = GENERATE(3, 5);
+  Index const window = GENERATE(1, 3);
+  bool const  shift = GENERATE(false, true);
+  Cx5         x(2, 17, 16, 15, 1);
+  x.setRandom();
+  Cx5     y(x.dimensions());
+  Cx5CMap xm(x.data(), x.dimensions());
+  Cx5Map  ym(y.data(), y.dimensions());
+  INFO("patch " << patch << " window " << window << " shift " << shift);
+
+  /* Windows tile the volume, so an identity patch function must reproduce x */
+  y.setZero();
+  Patches(patch, window, shift, [](Cx5 &, Index const) {}, xm, ym, 42);
+  CHECK(Norm(y - x) == Approx(0.f).margin(1.e-6f));
+
+  /* With a seed the shifted windows are the same every time */
+  auto scaled = [](Cx5 &xp, Index const) { xp = xp * xp.constant(Cx(xp(0, 0, 0, 0, 0).real())); };
+  Patches(patch, window, shift, scaled, xm, ym, 7);
+  Cx5 const y1 = y;
+  Patches(patch, window, shift, scaled, xm, ym, 7);
+  CHECK(Norm(y - y1) == Approx(0.f).margin(1.e-6f));
+}
@@ -0,0 +1,52 @@
+#include "log.hpp"
+#include "prox/entropy.hpp"
+#include "prox/norms.hpp"
+#include "prox/stack.hpp"
+#include "threads.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+using namespace rl;
+
+TEST_CASE("Prox Stack", "[prox]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const                       nT = GENERATE(1, 2, 8);
+  float const                       α = 0.5f;
+  std::vector<Proxs::Prox<Cx>::Ptr> ps{
+    std::make_shared<Proxs::L1>(1.f, 100000),
+    std::make_shared<Proxs::L2>(1.f, 40000, 8),
+    std::make_shared<Proxs::L2>(1.f, 20000, 20000),
+    std::make_shared<Proxs::Entropy>(1.f, 50000),
+    std::make_shared<Proxs::NMREntropy>(1.f, 30000),
+  };
+  Proxs::StackProx<Cx> stack(ps);
+  Eigen::VectorXcf     x(stack.sz);
+  x.setRandom();
+
+  /* Reference: each prox applied directly to its own segment, one after another on one thread */
+  Threads::SetGlobalThreadCount(1);
+  Eigen::VectorXcf serial(stack.sz);
+  Index            st = 0;
+  for (auto const &p : ps) {
+    Proxs::Prox<Cx>::CMap xm(x.data() + st, p->sz);
+    Proxs::Prox<Cx>::Map  zm(serial.data() + st, p->sz);
+    p->apply(α, xm, zm);
+    st += p->sz;
+  }
+
+  /* Soft thresholding is elementwise, so splitting it into blocks must not change a single bit */
+  float const            t = α;
+  Eigen::VectorXcf const l1 =
+    x.head(100000).cwiseAbs().cwiseTypedGreater(t).select(x.head(100000).array() * (x.head(100000).array().abs() - t) /
+                                                            x.head(100000).array().abs(),
+                                                          0.f);
+  CHECK((serial.head(100000).array() == l1.array()).all());
+
+  /* The stacked proxes run concurrently, and each can still spread across the pool */
+  Threads::SetGlobalThreadCount(nT);
+  Eigen::VectorXcf const z = stack.apply(α, x);
+  CHECK((z.array() == serial.array()).all());
+  Threads::SetGlobalThreadCount(0);
+}
@@ -0,0 +1,33 @@
+#include "threads.hpp"
+#include "log.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <atomic>
+
+using namespace rl;
+
+TEST_CASE("ParallelFor", "[threads]")
+{
+  Log::SetLevel(Log::Level::Testing);
+  Index const nT = GENERATE(1, 3, 8);
+  Index const grain = GENERATE(0, 1, 7, 1000);
+  Index const lo = 5, hi = 4101;
+  Threads::SetGlobalThreadCount(nT);
+  std::vector<std::atomic<Index>> visits(hi);
+  std::atomic<bool>               badWorker = false;
+  Threads::ParallelFor(lo, hi, grain, [&](Index const ilo, Index const ihi, Index const iw) {
+    if (iw < 0 || iw >= nT) { badWorker = true; }
+    for (Index ii = ilo; ii < ihi; ii++) {
+      visits[ii]++;
+    }
+  });
+  CHECK(!badWorker);
+  Index wrong = 0;
+  for (Index ii = 0; ii < hi; ii++) {
+    if (visits[ii] != (ii < lo ? 0 : 1)) { wrong++; }
+  }
+  CHECK(wrong == 0);
+  Threads::SetGlobalThreadCount(0);
+}
@@ -1,10 +1,12 @@
 #include "admm.hpp"
 
+#include "cg.hpp"
 #include "log.hpp"
 #include "lsmr.hpp"
 #include "op/top.hpp"
 #include "signals.hpp"
 #include "tensors.hpp"
+#include "threads.hpp"
 
 namespace rl {
 
@@ -29,6 +31,7 @@ auto ADMM::run(CMap const b, float ρ) const -> Vector
     u_i = F_i * x + u_{i-1} - z_i
     */
   if (b.rows() != A->rows()) { Log::Fail("ADMM: b was size {} expected {}", b.rows(), A->rows()); }
+  if (checkEvery < 1) { Log::Fail("ADMM: convergence check interval {} must be at least 1", checkEvery); }
   auto const dev = Threads::GlobalDevice();
 
   Index const                                      R = regs.size();
@@ -59,41 +62,117 @@ auto ADMM::run(CMap const b, float ρ) const -> Vector
   bʹ.setZero();
   bʹ.head(A->rows()).device(dev) = b;
 
+  /* With a normal operator the same least-squares problem is solved via
+   * (A'M⁻¹A + ρ Σ F_i'F_i) x = A'M⁻¹b + ρ Σ F_i'(z_i - u_i)
+   */
+  Vector                                           Aʹb, bN;
+  std::shared_ptr<Op>                              Nʹ = N;
+  std::vector<std::shared_ptr<Ops::DiagScale<Cx>>> ρNdiags(R);
+  if (N) {
+    Log::Print("ADMM inner problem via normal equations");
+    Vector Mb(A->rows());
+    Map    Mbm(Mb.data(), Mb.size());
+    M->inverse(b, Mbm);
+    Aʹb = A->adjoint(Mb);
+    for (Index ir = 0; ir < R; ir++) {
+      ρNdiags[ir] = std::make_shared<Ops::DiagScale<Cx>>(A->cols(), ρ);
+      auto FʹF = std::make_shared<NormalOp<Cx>>(regs[ir].T);
+      Nʹ = std::make_shared<Ops::Add<Cx>>(Nʹ, std::make_shared<Ops::Multiply<Cx>>(ρNdiags[ir], FʹF));
+    }
+  }
+  ConjugateGradients<Cx> cg{Nʹ, iters0, aTol};
+
+  /* Per-regularizer buffers, so the outer loop does not allocate. With a normal operator F'z and F'u are needed for the
+   * next right-hand side, so they are kept and the dual residuals reuse them instead of applying F' again. Without one,
+   * a checked iteration still costs one forward and two adjoints per regularizer, the same as before. Updating F'u from
+   * the previous iteration would need F'(Fx - z), which is another adjoint, so nothing is saved.
+   */
+  std::vector<Vector> Fx(R), Fxpu(R), zprev(R), FʹzN(R), FʹuN(R), Fʹv(R);
+  std::vector<float>  nFx(R), nz(R), nu(R), nP(R), nD(R);
+  for (Index ir = 0; ir < R; ir++) {
+    Index const sz = regs[ir].T->rows();
+    Fʹv[ir].resize(A->cols());
+    Fx[ir].resize(sz);
+    Fxpu[ir].resize(sz);
+    zprev[ir].resize(sz);
+    if (N) {
+      FʹzN[ir].resize(A->cols());
+      FʹzN[ir].setZero();
+      FʹuN[ir].resize(A->cols());
+      FʹuN[ir].setZero();
+    }
+  }
+
   Log::Print("ADMM Abs ε {}", ε);
   PushInterrupt();
   for (Index io = 0; io < outerLimit; io++) {
-    Index start = A->rows();
-    for (Index ir = 0; ir < R; ir++) {
-      Index rr = regs[ir].T->rows();
-      bʹ.segment(start, rr).device(dev) = std::sqrt(ρ) * (z[ir] - u[ir]);
-      start += rr;
-      ρdiags[ir]->scale = std::sqrt(ρ);
+    if (N) {
+      bN = Aʹb;
+      for (Index ir = 0; ir < R; ir++) {
+        bN.device(dev) = bN + ρ * (FʹzN[ir] - FʹuN[ir]);
+        ρNdiags[ir]->scale = ρ;
+      }
+      x = cg.run(bN.data(), io > 0 ? x.data() : nullptr);
+      cg.iterLimit = iters1;
+    } else {
+      Index start = A->rows();
+      for (Index ir = 0; ir < R; ir++) {
+        Index rr = regs[ir].T->rows();
+        bʹ.segment(start, rr).device(dev) = std::sqrt(ρ) * (z[ir] - u[ir]);
+        start += rr;
+        ρdiags[ir]->scale = std::sqrt(ρ);
+      }
+      x = lsmr.run(bʹ, 0.f, x);
+      lsmr.iterLimit = iters1;
     }
-    x = lsmr.run(bʹ, 0.f, x);
-    lsmr.iterLimit = iters1;
     if (debug_x) { debug_x(io, x); }
 
+    /* Regularizers touch only their own buffers, so are updated concurrently. Norms are summed afterwards in order. */
+    bool const check = (io + 1) % checkEvery == 0 || io == outerLimit - 1;
+    Threads::Concurrent(
+      [&](Index const ir) {
+        regs[ir].T->forward(x, Fx[ir]);
+        Fxpu[ir].device(dev) = Fx[ir] + u[ir];
+        std::swap(zprev[ir], z[ir]);
+        regs[ir].P->apply(1.f / ρ, Fxpu[ir], z[ir]);
+        u[ir].device(dev) = Fxpu[ir] - z[ir];
+        if (N) {
+          regs[ir].T->adjoint(z[ir], Fʹv[ir]);
+          FʹzN[ir].device(dev) = Fʹv[ir] - FʹzN[ir];
+          nD[ir] = BLAS::Norm(FʹzN[ir]);
+          std::swap(Fʹv[ir], FʹzN[ir]);
+          regs[ir].T->adjoint(u[ir], FʹuN[ir]);
+          nu[ir] = BLAS::Norm(FʹuN[ir]);
+        } else if (check) {
+          zprev[ir].device(dev) = z[ir] - zprev[ir];
+          regs[ir].T->adjoint(zprev[ir], Fʹv[ir]);
+          nD[ir] = BLAS::Norm(Fʹv[ir]);
+          regs[ir].T->adjoint(u[ir], Fʹv[ir]);
+          nu[ir] = BLAS::Norm(Fʹv[ir]);
+        }
+        if (!check) { return; }
+        nFx[ir] = BLAS::Norm(Fx[ir]);
+        nz[ir] = BLAS::Norm(z[ir]);
+        Fxpu[ir].device(dev) = Fx[ir] - z[ir];
+        nP[ir] = BLAS::Norm(Fxpu[ir]);
+      },
+      R);
     float normFx = 0.f, normz = 0.f, normu = 0.f, pRes = 0.f, dRes = 0.f;
     for (Index ir = 0; ir < R; ir++) {
-      Vector const Fx = regs[ir].T->forward(x);
-      Vector const Fxpu = Fx + u[ir];
-      Vector const zprev = z[ir];
-      regs[ir].P->apply(1.f / ρ, Fxpu, z[ir]);
-      u[ir].device(dev) = Fxpu - z[ir];
-      if (debug_z) { debug_z(io, ir, Fx, z[ir], u[ir]); }
-      float const nFx = Fx.stableNorm();
-      float const nz = z[ir].stableNorm();
-      float const nu = regs[ir].T->adjoint(u[ir]).stableNorm();
-      float const nP = (Fx - z[ir]).stableNorm();
-      float const nD = (regs[ir].T->adjoint(z[ir] - zprev)).stableNorm();
-      normFx += nFx * nFx;
-      normz += nz * nz;
-      normu += nu * nu;
-      pRes += nP * nP;
-      dRes += nD * nD;
-      Log::Print("Reg {:02d} |Fx| {:4.3E} |z| {:4.3E} |F'u| {:4.3E}", ir, nFx, nz, nu);
+      if (debug_z) { debug_z(io, ir, Fx[ir], z[ir], u[ir]); }
+      if (!check) { continue; }
+      normFx += nFx[ir] * nFx[ir];
+      normz += nz[ir] * nz[ir];
+      normu += nu[ir] * nu[ir];
+      pRes += nP[ir] * nP[ir];
+      dRes += nD[ir] * nD[ir];
+      Log::Print("Reg {:02d} |Fx| {:4.3E} |z| {:4.3E} |F'u| {:4.3E}", ir, nFx[ir], nz[ir], nu[ir]);
+    }
+    if (!check) {
+      if (InterruptReceived()) { break; }
+      continue;
     }
-    float const normx = x.stableNorm();
+    float const normx = BLAS::Norm(x);
     normFx = std::sqrt(normFx);
     normz = std::sqrt(normz);
     normu = std::sqrt(normu);
@@ -115,11 +194,13 @@ auto ADMM::run(CMap const b, float ρ) const -> Vector
         ρ *= τ;
         for (Index ir = 0; ir < R; ir++) {
           u[ir] /= τ;
+          if (N) { FʹuN[ir] /= τ; }
         }
       } else if (dRes > μ * pRes) {
         ρ /= τ;
         for (Index ir = 0; ir < R; ir++) {
           u[ir] *= τ;
+          if (N) { FʹuN[ir] *= τ; }
         }
       }
     }
@@ -33,6 +33,9 @@ struct ADMM
   DebugX debug_x = nullptr;
   DebugZ debug_z = nullptr;
 
+  Op::Ptr N = nullptr; // Optional A'M⁻¹A, e.g. Toeplitz embedded. If set the inner problem is solved with CG
+  Index   checkEvery = 1; // Calculate residuals, test convergence and rebalance ρ every this many outer iterations
+
   auto run(Vector const &b, float const ρ) const -> Vector;
   auto run(CMap const b, float const ρ) const -> Vector;
 };
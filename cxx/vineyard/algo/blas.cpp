@@ -0,0 +1,133 @@
+#include "blas.hpp"
+
+#include "log.hpp"
+#include "threads.hpp"
+
+#include <vector>
+
+namespace rl {
+namespace BLAS {
+
+namespace {
+Index constexpr BlockSize = 1 << 15; // Elements per parallel block
+Index constexpr ChunkSize = 1 << 10; // Elements summed in single precision before accumulating in double
+
+auto Blocks(Index const n) -> Index { return (n + BlockSize - 1) / BlockSize; }
+
+/* Call f(ib, lo, hi) for each block of [0, n) across the thread pool */
+template <typename F> void ForBlocks(Index const n, F &&f)
+{
+  Index const nB = Blocks(n);
+  if (nB == 1) {
+    f(0, 0, n);
+  } else if (nB > 1) {
+    Threads::ParallelFor(0, nB, 1, [&](Index const lo, Index const hi) {
+      for (Index ib = lo; ib < hi; ib++) {
+        f(ib, ib * BlockSize, std::min(n, (ib + 1) * BlockSize));
+      }
+    });
+  }
+}
+
+/* Sum f(lo, hi) over chunks of [lo, hi) in double precision */
+template <typename D, typename F> auto SumChunks(Index const lo, Index const hi, F &&f) -> D
+{
+  D s = 0;
+  for (Index ic = lo; ic < hi; ic += ChunkSize) {
+    s += static_cast<D>(f(ic, std::min(hi, ic + ChunkSize)));
+  }
+  return s;
+}
+
+template <typename D> auto PairwiseSum(D const *p, Index const n) -> D
+{
+  if (n == 0) { return D(0); }
+  if (n == 1) { return p[0]; }
+  Index const mid = n / 2;
+  return PairwiseSum(p, mid) + PairwiseSum(p + mid, n - mid);
+}
+
+/* Reduce g(lo, hi) over chunks of [0, n), calling pre(lo, hi) on each block first */
+template <typename D, typename Pre, typename G> auto Reduce(Index const n, Pre &&pre, G &&g) -> D
+{
+  std::vector<D> partials(Blocks(n));
+  ForBlocks(n, [&](Index const ib, Index const lo, Index const hi) {
+    pre(lo, hi);
+    partials[ib] = SumChunks<D>(lo, hi, g);
+  });
+  return PairwiseSum(partials.data(), partials.size());
+}
+
+auto NoPre = [](Index const, Index const) {};
+
+template <typename T> void CheckSizes(CRef<T> const &x, Eigen::Index const ny, char const *name)
+{
+  if (x.size() != ny) { Log::Fail("{} vectors had size {} and {}", name, x.size(), ny); }
+}
+
+template <typename T> auto DotT(CRef<T> const &x, CRef<T> const &y) -> T
+{
+  CheckSizes<T>(x, y.size(), "Dot");
+  using D = std::conditional_t<std::is_same_v<T, Cx>, std::complex<double>, double>;
+  D const d = Reduce<D>(x.size(), NoPre, [&](Index const lo, Index const hi) {
+    return x.segment(lo, hi - lo).dot(y.segment(lo, hi - lo));
+  });
+  return static_cast<T>(d);
+}
+
+template <typename T> auto SquaredNormT(CRef<T> const &x) -> float
+{
+  return Reduce<double>(x.size(), NoPre, [&](Index const lo, Index const hi) { return x.segment(lo, hi - lo).squaredNorm(); });
+}
+
+template <typename T> auto NormT(CRef<T> const &x) -> float
+{
+  /* stableNorm per chunk avoids overflow in single precision, and its square cannot overflow in double */
+  return std::sqrt(Reduce<double>(x.size(), NoPre, [&](Index const lo, Index const hi) {
+    double const n = x.segment(lo, hi - lo).stableNorm();
+    return n * n;
+  }));
+}
+
+template <typename T> auto AxpyNormT(float const a, CRef<T> const &x, Ref<T> y) -> float
+{
+  CheckSizes<T>(x, y.size(), "Axpy");
+  return Reduce<double>(
+    x.size(), [&](Index const lo, Index const hi) { y.segment(lo, hi - lo) += a * x.segment(lo, hi - lo); },
+    [&](Index const lo, Index const hi) { return y.segment(lo, hi - lo).squaredNorm(); });
+}
+
+template <typename T> void AxpyT(float const a, CRef<T> const &x, Ref<T> y)
+{
+  CheckSizes<T>(x, y.size(), "Axpy");
+  ForBlocks(x.size(), [&](Index, Index const lo, Index const hi) { y.segment(lo, hi - lo) += a * x.segment(lo, hi - lo); });
+}
+
+template <typename T> void XpbyT(CRef<T> const &x, float const b, Ref<T> y)
+{
+  CheckSizes<T>(x, y.size(), "Xpby");
+  ForBlocks(x.size(), [&](Index, Index const lo, Index const hi) {
+    y.segment(lo, hi - lo) = x.segment(lo, hi - lo) + b * y.segment(lo, hi - lo);
+  });
+}
+} // namespace
+
+auto Dot(CRef<float> const &x, CRef<float> const &y) -> float { return DotT<float>(x, y); }
+auto Dot(CRef<Cx> const &x, CRef<Cx> const &y) -> Cx { return DotT<Cx>(x, y); }
+
+auto SquaredNorm(CRef<float> const &x) -> float { return SquaredNormT<float>(x); }
+auto SquaredNorm(CRef<Cx> const &x) -> float { return SquaredNormT<Cx>(x); }
+auto Norm(CRef<float> const &x) -> float { return NormT<float>(x); }
+auto Norm(CRef<Cx> const &x) -> float { return NormT<Cx>(x); }
+
+void Axpy(float const a, CRef<float> const &x, Ref<float> y) { AxpyT<float>(a, x, y); }
+void Axpy(float const a, CRef<Cx> const &x, Ref<Cx> y) { AxpyT<Cx>(a, x, y); }
+
+auto AxpyNorm(float const a, CRef<float> const &x, Ref<float> y) -> float { return AxpyNormT<float>(a, x, y); }
+auto AxpyNorm(float const a, CRef<Cx> const &x, Ref<Cx> y) -> float { return AxpyNormT<Cx>(a, x, y); }
+
+void Xpby(CRef<float> const &x, float const b, Ref<float> y) { XpbyT<float>(x, b, y); }
+void Xpby(CRef<Cx> const &x, float const b, Ref<Cx> y) { XpbyT<Cx>(x, b, y); }
+
+} // namespace BLAS
+} // namespace rl
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "types.hpp"
+
+namespace rl {
+
+/*
+ * Parallel vector arithmetic for the iterative solvers. Vectors are cut into fixed-size blocks that are spread across
+ * the global thread pool. Reductions keep one partial per block, accumulated in double precision, and combine the
+ * partials pairwise in block order, so results do not depend on the thread count or on which worker ran which block.
+ */
+namespace BLAS {
+
+template <typename T> using CRef = Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1> const>;
+template <typename T> using Ref = Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>>;
+
+auto Dot(CRef<float> const &x, CRef<float> const &y) -> float;
+auto Dot(CRef<Cx> const &x, CRef<Cx> const &y) -> Cx; // Conjugates x, as Eigen's dot does
+
+auto SquaredNorm(CRef<float> const &x) -> float;
+auto SquaredNorm(CRef<Cx> const &x) -> float;
+auto Norm(CRef<float> const &x) -> float; // Does not overflow, like stableNorm
+auto Norm(CRef<Cx> const &x) -> float;
+
+/* y = y + a x */
+void Axpy(float const a, CRef<float> const &x, Ref<float> y);
+void Axpy(float const a, CRef<Cx> const &x, Ref<Cx> y);
+
+/* y = y + a x, returning |y|² from the same pass */
+auto AxpyNorm(float const a, CRef<float> const &x, Ref<float> y) -> float;
+auto AxpyNorm(float const a, CRef<Cx> const &x, Ref<Cx> y) -> float;
+
+/* y = x + b y */
+void Xpby(CRef<float> const &x, float const b, Ref<float> y);
+void Xpby(CRef<Cx> const &x, float const b, Ref<Cx> y);
+
+} // namespace BLAS
+} // namespace rl
@@ -1,5 +1,6 @@
 #include "cg.hpp"
 
+#include "blas.hpp"
 #include "op/top.hpp"
 
 namespace rl {
@@ -24,7 +25,7 @@ auto ConjugateGradients<Scalar>::run(Scalar *bdata, Scalar *x0data) const -> Vec
     x.setZero();
   }
   p = r;
-  float       r_old = r.squaredNorm();
+  float       r_old = BLAS::SquaredNorm(r);
   float const thresh = resTol * std::sqrt(r_old);
   Log::Print("CG |r| {:4.3E} threshold {:4.3E}", std::sqrt(r_old), thresh);
   Log::Print("IT |r|       α         β         |x|");
@@ -32,19 +33,18 @@ auto ConjugateGradients<Scalar>::run(Scalar *bdata, Scalar *x0data) const -> Vec
   for (Index icg = 0; icg < iterLimit; icg++) {
     op->forward(p, q);
     float const α = r_old / CheckedDot(p, q);
-    x = x + p * α;
+    BLAS::Axpy(α, p, x);
     if (debug) {
-      if (auto top = std::dynamic_pointer_cast<TOp<Cx, 5, 4>>(op)) {
+      if (auto top = std::dynamic_pointer_cast<TOps::TOp<Cx, 5, 4>>(op)) {
         Log::Tensor(fmt::format("cg-x-{:02}", icg), top->ishape, x.data());
         Log::Tensor(fmt::format("cg-r-{:02}", icg), top->ishape, r.data());
       }
     }
-    r = r - q * α;
-    float const r_new = r.squaredNorm();
+    float const r_new = BLAS::AxpyNorm(-α, q, r);
     float const β = r_new / r_old;
-    p = r + p * β;
+    BLAS::Xpby(r, β, p);
     float const nr = sqrt(r_new);
-    Log::Print("{:02d} {:4.3E} {:4.3E} {:4.3E} {:4.3E}", icg, nr, α, β, x.stableNorm());
+    Log::Print("{:02d} {:4.3E} {:4.3E} {:4.3E} {:4.3E}", icg, nr, α, β, BLAS::Norm(x));
     if (nr < thresh) {
       Log::Print("Reached convergence threshold");
       break;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "arena.hpp"
 #include "common.hpp"
 #include "op/ops.hpp"
 #include "signals.hpp"
@@ -33,13 +34,23 @@ struct NormalOp final : Ops::Op<Scalar_>
 
   void forward(CMap const &x, Map &y) const
   {
-    Vector temp(op->rows());
-    Map    tm(temp.data(), temp.size());
-    CMap   tcm(temp.data(), temp.size());
+    Arena::Lease temp(op->rows() * sizeof(Scalar));
+    Map          tm(temp.data<Scalar>(), op->rows());
+    CMap         tcm(temp.data<Scalar>(), op->rows());
     op->forward(x, tm);
     op->adjoint(tcm, y);
   }
   void adjoint(CMap const &x, Map &y) const { Log::Fail("Normal Operators do not have adjoints"); }
+
+  void iforward(CMap const &x, Map &y) const
+  {
+    Arena::Lease temp(op->rows() * sizeof(Scalar));
+    Map          tm(temp.data<Scalar>(), op->rows());
+    CMap         tcm(temp.data<Scalar>(), op->rows());
+    op->forward(x, tm);
+    op->iadjoint(tcm, y);
+  }
+  void iadjoint(CMap const &x, Map &y) const { Log::Fail("Normal Operators do not have adjoints"); }
 };
 
 template <typename Scalar = Cx>
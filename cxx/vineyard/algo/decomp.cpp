@@ -73,4 +73,39 @@ template struct SVD<float>;
 template struct SVD<Cx>;
 template struct SVD<Cxd>;
 
+SVDShrink::SVDShrink(Index const rows, Index const cols)
+  : wide{rows <= cols}
+  , eig(std::min(rows, cols))
+{
+  Index const n = std::min(rows, cols);
+  G.resize(n, n);
+  Vf.resize(n, n);
+  W.resize(n, n);
+  WA.resize(rows, cols);
+  f.resize(n);
+}
+
+void SVDShrink::apply(float const λ, Eigen::Ref<Eigen::MatrixXcf> A)
+{
+  if (A.rows() != WA.rows() || A.cols() != WA.cols()) {
+    Log::Fail("SVDShrink matrix was {}x{} expected {}x{}", A.rows(), A.cols(), WA.rows(), WA.cols());
+  }
+  if (wide) {
+    G.noalias() = A * A.adjoint();
+  } else {
+    G.noalias() = A.adjoint() * A;
+  }
+  eig.compute(G);
+  f = eig.eigenvalues().array().max(0.f).sqrt();
+  f = (f > λ).select(1.f - λ / f, 0.f);
+  Vf.noalias() = eig.eigenvectors() * f.matrix().asDiagonal();
+  W.noalias() = Vf * eig.eigenvectors().adjoint();
+  if (wide) {
+    WA.noalias() = W * A;
+  } else {
+    WA.noalias() = A * W;
+  }
+  A = WA;
+}
+
 } // namespace rl
@@ -28,4 +28,22 @@ template <typename Scalar = Cx> struct SVD
   auto equalized(Index const N) const -> Matrix;   // Equalize variance over first N vectors
 };
 
+/*
+ * Soft-threshold the singular values of a matrix in place, A ← U max(S - λ, 0) Vᴴ, without a full SVD. The Gram matrix
+ * along the short dimension is eigen-decomposed instead, e.g. AAᴴ = V S² Vᴴ when A has fewer rows than columns, and
+ * the shrinkage is then the product A ← V max(1 - λ/S, 0) Vᴴ A. All workspace is sized at construction, so repeated
+ * calls on matrices of the same shape do not allocate. Intended for the many small patch matrices in LLR.
+ */
+struct SVDShrink
+{
+  SVDShrink(Index const rows, Index const cols);
+  void apply(float const λ, Eigen::Ref<Eigen::MatrixXcf> A);
+
+private:
+  bool                                            wide;
+  Eigen::MatrixXcf                                G, Vf, W, WA;
+  Eigen::ArrayXf                                  f;
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXcf> eig;
+};
+
 } // namespace rl
@@ -53,7 +53,7 @@ auto LSMR::run(CMap const b, float const λ, CMap x0) const -> Vector
   float const normb = β;
 
   Log::Print("IT |x|       |r|       |A'r|     |A|       cond(A)");
-  Log::Print("{:02d} {:4.3E} {:4.3E} {:4.3E}", 0, x.stableNorm(), normb, std::fabs(ζ̅));
+  Log::Print("{:02d} {:4.3E} {:4.3E} {:4.3E}", 0, BLAS::Norm(x), normb, std::fabs(ζ̅));
   PushInterrupt();
   for (Index ii = 0; ii < iterLimit; ii++) {
     Bidiag(op, M, Mu, u, v, α, β);
@@ -80,9 +80,9 @@ auto LSMR::run(CMap const b, float const λ, CMap x0) const -> Vector
     ζ̅ = -s̅ * ζ̅;
 
     // Update h, h̅, x.
-    h̅.device(Threads::GlobalDevice()) = h - (θ̅ * ρ / (ρold * ρ̅old)) * h̅;
-    x.device(Threads::GlobalDevice()) = x + (ζ / (ρ * ρ̅)) * h̅;
-    h.device(Threads::GlobalDevice()) = v - (θnew / ρ) * h;
+    BLAS::Xpby(h, -θ̅ * ρ / (ρold * ρ̅old), h̅);
+    BLAS::Axpy(ζ / (ρ * ρ̅), h̅, x);
+    BLAS::Xpby(v, -θnew / ρ, h);
 
     // Estimate of |r|.
     float const β́ = ĉ * β̈;
@@ -113,7 +113,7 @@ auto LSMR::run(CMap const b, float const λ, CMap x0) const -> Vector
 
     // Convergence tests - go in pairs which check large/small values then the user tolerance
     float const normAr = abs(ζ̅);
-    float const normx = x.stableNorm();
+    float const normx = BLAS::Norm(x);
 
     Log::Print("{:02d} {:4.3E} {:4.3E} {:4.3E} {:4.3E} {:4.3E}", ii + 1, normx, normr, normAr, normA, condA);
     if (debug) { debug(ii, x); }
@@ -29,7 +29,7 @@ auto LSQR::run(CMap const b, float const λ, CMap const x0) const -> Vector
 
   if (iterLimit == 0) { // Bug out and return v
     x = v * (α * β);
-    Log::Print("LSMR 0 |x| {:4.3E}", x.stableNorm());
+    Log::Print("LSMR 0 |x| {:4.3E}", BLAS::Norm(x));
     return x;
   }
 
@@ -41,7 +41,7 @@ auto LSQR::run(CMap const b, float const λ, CMap const x0) const -> Vector
   float sn2 = 0.f;
 
   Log::Print("IT |x|       |r|       |A'r|     |A|       cond(A)");
-  Log::Print("{:02d} {:4.3E} {:4.3E} {:4.3E}", 0, x.stableNorm(), β, std::fabs(α * β));
+  Log::Print("{:02d} {:4.3E} {:4.3E} {:4.3E}", 0, BLAS::Norm(x), β, std::fabs(α * β));
   PushInterrupt();
   for (Index ii = 0; ii < iterLimit; ii++) {
     Bidiag(op, M, Mu, u, v, α, β);
@@ -62,8 +62,8 @@ auto LSQR::run(CMap const b, float const λ, CMap const x0) const -> Vector
     float const τ = s * ɸ;
     float const θ = s * α;
     ρ̅ = -c * α;
-    x = x + w * (ɸ / ρ);
-    w = v - w * (θ / ρ);
+    BLAS::Axpy(ɸ / ρ, w, x);
+    BLAS::Xpby(v, -θ / ρ, w);
 
     // Estimate norms
     float const δ = sn2 * ρ;
@@ -75,7 +75,7 @@ auto LSQR::run(CMap const b, float const λ, CMap const x0) const -> Vector
     std::tie(cs2, sn2, ɣ) = StableGivens(ɣ̅, θ);
     z = rhs / ɣ;
     xxnorm += z * z;
-    ddnorm = ddnorm + w.squaredNorm() / (ρ * ρ);
+    ddnorm = ddnorm + BLAS::SquaredNorm(w) / (ρ * ρ);
 
     normA = std::sqrt(normA * normA + α * α + β * β + λ * λ);
     float const condA = normA * std::sqrt(ddnorm);
@@ -6,6 +6,7 @@
 #include "prox/lsq.hpp"
 #include "prox/stack.hpp"
 #include "tensors.hpp"
+#include "threads.hpp"
 
 namespace rl {
 
@@ -78,11 +79,11 @@ auto PDHG::run(Cx const *bdata, Index const iterLimit) -> Vector
     xold = x;
     v = u + σOp->forward(Aʹ->forward(x̅));
     proxʹ->apply(σOp, v, u);
-    x = x - τ * Aʹ->adjoint(u);
-    xdiff = x - xold;
-    x̅ = x + xdiff;
-    float const normr = xdiff.stableNorm() / std::sqrt(τ);
-    Log::Print("PDHG {:02d}: |x| {:4.3E} |r| {:4.3E}", ii, x.stableNorm(), normr);
+    BLAS::Axpy(-τ, Aʹ->adjoint(u), x);
+    xdiff.device(Threads::GlobalDevice()) = x - xold;
+    x̅.device(Threads::GlobalDevice()) = x + xdiff;
+    float const normr = BLAS::Norm(xdiff) / std::sqrt(τ);
+    Log::Print("PDHG {:02d}: |x| {:4.3E} |r| {:4.3E}", ii, BLAS::Norm(x), normr);
     if (debug) { debug(ii, x, x̅, xdiff); }
   }
   return x;
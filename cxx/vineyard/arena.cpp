@@ -0,0 +1,108 @@
+#include "arena.hpp"
+
+#include "log.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+namespace rl {
+namespace Arena {
+
+namespace {
+Index constexpr Alignment = 64;
+
+std::atomic<Index> allocated{0}, peak{0}, nBlocks{0};
+
+auto Round(Index const bytes) -> Index { return ((bytes + Alignment - 1) / Alignment) * Alignment; }
+
+struct Block
+{
+  std::byte *base;
+  Index      size;
+  Index      top = 0;
+};
+
+auto Allocate(Index const size) -> Block
+{
+  auto const base = static_cast<std::byte *>(std::aligned_alloc(Alignment, size));
+  if (!base) { Log::Fail("Could not allocate {} MB of operator scratch space", size / (1024 * 1024)); }
+  nBlocks++;
+  Index const now = allocated.fetch_add(size) + size;
+  Index       p = peak.load();
+  while (now > p && !peak.compare_exchange_weak(p, now)) {}
+  return Block{base, size};
+}
+
+void Free(Block const &b)
+{
+  std::free(b.base);
+  allocated.fetch_sub(b.size);
+}
+
+struct Stack
+{
+  std::vector<Block> blocks;
+  Index              depth = 0, live = 0, highWater = 0;
+
+  ~Stack()
+  {
+    for (auto const &b : blocks) {
+      Free(b);
+    }
+  }
+
+  auto push(Index const bytes) -> void *
+  {
+    if (blocks.empty() || blocks.back().top + bytes > blocks.back().size) { blocks.push_back(Allocate(bytes)); }
+    auto      &b = blocks.back();
+    void *const p = b.base + b.top;
+    b.top += bytes;
+    depth++;
+    live += bytes;
+    highWater = std::max(highWater, live);
+    return p;
+  }
+
+  void pop(void *const p, Index const bytes)
+  {
+    auto const bp = static_cast<std::byte *>(p);
+    for (auto ib = blocks.rbegin(); ib != blocks.rend(); ib++) {
+      if (bp >= ib->base && bp < ib->base + ib->size) {
+        ib->top -= bytes;
+        break;
+      }
+    }
+    depth--;
+    live -= bytes;
+    if (depth == 0 && blocks.size() > 1) {
+      for (auto const &b : blocks) {
+        Free(b);
+      }
+      blocks.clear();
+      blocks.push_back(Allocate(highWater));
+      Log::Debug("Operator scratch arena merged to {} MB", highWater / (1024 * 1024));
+    }
+  }
+};
+
+thread_local Stack stack;
+} // namespace
+
+Lease::Lease(Index const bytes)
+  : ptr_{nullptr}
+  , bytes_{Round(bytes)}
+{
+  if (bytes_ > 0) { ptr_ = stack.push(bytes_); }
+}
+
+Lease::~Lease()
+{
+  if (bytes_ > 0) { stack.pop(ptr_, bytes_); }
+}
+
+auto Peak() -> Index { return peak.load(); }
+auto Blocks() -> Index { return nBlocks.load(); }
+
+} // namespace Arena
+} // namespace rl
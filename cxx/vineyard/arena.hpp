@@ -0,0 +1,39 @@
+#pragma once
+
+#include "types.hpp"
+
+namespace rl {
+
+/*
+ * Scratch space for operator intermediates, so that composite operators do not allocate on every application.
+ *
+ * An operator takes a Lease for the duration of a call. Calls nest strictly, so each thread's arena is a stack: a lease
+ * is carved from the top of the current block and returned in reverse order. If a lease does not fit, another block is
+ * chained on. When the last lease is returned the blocks are merged into one of the high-water size, so after the first
+ * application of an operator tree no further allocations happen and nested compositions share the same memory.
+ *
+ * Blocks are sized from the leases actually made on each thread, so a pool thread that only takes a small lease only
+ * holds a small block. Stacks keep their blocks until the thread exits, so the peak is only known after the operators
+ * have run on every thread that will use them.
+ */
+namespace Arena {
+
+struct Lease
+{
+  Lease(Index const bytes);
+  ~Lease();
+  Lease(Lease const &) = delete;
+  Lease &operator=(Lease const &) = delete;
+
+  template <typename T> auto data() const -> T * { return static_cast<T *>(ptr_); }
+
+private:
+  void *ptr_;
+  Index bytes_;
+};
+
+auto Peak() -> Index;   // Peak bytes allocated across all threads
+auto Blocks() -> Index; // Number of blocks allocated so far across all threads
+
+} // namespace Arena
+} // namespace rl
@@ -35,12 +35,9 @@ auto Basis::nB() const -> Index { return B.dimension(0); }
 auto Basis::nSample() const -> Index { return B.dimension(1); }
 auto Basis::nTrace() const -> Index { return B.dimension(2); }
 
-auto Basis::entry(Index const s, Index const t) const -> Cx1 {
-  return B.chip<2>(t % B.dimension(2)).chip<1>(s % B.dimension(1));
-}
-
-auto Basis::entryConj(Index const s, Index const t) const -> Cx1 {
-  return B.chip<2>(t % B.dimension(2)).chip<1>(s % B.dimension(1)).conjugate();
+auto Basis::entry(Index const s, Index const t) const -> Cx1CMap
+{
+  return Cx1CMap(&B(0, s % B.dimension(1), t % B.dimension(2)), Sz1{B.dimension(0)});
 }
 
 void Basis::write(std::string const &basisFile) const
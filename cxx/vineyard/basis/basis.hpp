@@ -21,8 +21,7 @@ struct Basis {
     auto nSample() const -> Index;
     auto nTrace() const -> Index;
 
-    auto entry(Index const sample, Index const trace) const -> Cx1;
-    auto entryConj(Index const sample, Index const trace) const -> Cx1;
+    auto entry(Index const sample, Index const trace) const -> Cx1CMap; // View into B, no copy
 
     void write(std::string const &basisFile) const;
     void concat(Basis const &other);
@@ -0,0 +1,128 @@
+#include "cache.hpp"
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace rl {
+namespace Cache {
+
+namespace {
+fs::path directory;
+Index    budgetMB = 0;
+
+auto EntryPath(std::string const &kind, Key const &key) -> fs::path { return directory / (kind + "-" + key.hex() + ".h5"); }
+
+/* Only ever touch files that look like one of our own entries, in case the directory is shared with real data */
+auto IsEntry(fs::directory_entry const &e) -> bool
+{
+  if (!e.is_regular_file() || e.path().extension() != ".h5") { return false; }
+  auto const stem = e.path().stem().string();
+  auto const dash = stem.rfind('-');
+  return dash != std::string::npos && stem.size() - dash == 17 &&
+         std::all_of(stem.begin() + dash + 1, stem.end(), [](char const c) { return std::isxdigit(c); });
+}
+
+void Evict()
+{
+  if (budgetMB < 1) { return; }
+  std::vector<fs::directory_entry> entries;
+  uintmax_t                        total = 0;
+  for (auto const &e : fs::directory_iterator(directory)) {
+    if (IsEntry(e)) {
+      entries.push_back(e);
+      total += e.file_size();
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](fs::directory_entry const &a, fs::directory_entry const &b) { return a.last_write_time() < b.last_write_time(); });
+  uintmax_t const budget = budgetMB * 1024 * 1024;
+  for (auto const &e : entries) {
+    if (total <= budget) { break; }
+    total -= e.file_size();
+    std::error_code ec;
+    fs::remove(e.path(), ec);
+    Log::Print("Evicted cache entry {}", e.path().string());
+  }
+}
+} // namespace
+
+void SetDirectory(std::string const &dir)
+{
+  directory = dir;
+  if (!directory.empty()) {
+    fs::create_directories(directory);
+    Log::Print("Cache directory {}", directory.string());
+  }
+}
+
+void SetBudget(Index const MB) { budgetMB = MB; }
+
+auto Enabled() -> bool { return !directory.empty(); }
+
+auto Key::add(std::string const &s) -> Key & { return bytes(reinterpret_cast<uint8_t const *>(s.data()), s.size()); }
+
+auto Key::bytes(uint8_t const *data, Index const n) -> Key &
+{
+  uint64_t constexpr prime = 1099511628211ULL;
+  Index ii = 0;
+  for (; ii + 8 <= n; ii += 8) {
+    uint64_t w;
+    std::memcpy(&w, data + ii, 8);
+    h_ = (h_ ^ w) * prime;
+  }
+  for (; ii < n; ii++) {
+    h_ = (h_ ^ data[ii]) * prime;
+  }
+  return *this;
+}
+
+auto Key::hex() const -> std::string { return fmt::format("{:016x}", h_); }
+
+auto Lookup(std::string const &kind, Key const &key) -> std::optional<std::string>
+{
+  if (!Enabled()) { return std::nullopt; }
+  auto const      path = EntryPath(kind, key);
+  std::error_code ec;
+  if (!fs::exists(path, ec)) {
+    Log::Print("Cache miss {}", path.string());
+    return std::nullopt;
+  }
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec); // Mark as recently used for eviction
+  Log::Print("Cache hit {}", path.string());
+  return path.string();
+}
+
+void Store(std::string const &kind, Key const &key, std::function<void(HD5::Writer &)> const &write)
+{
+  if (!Enabled()) { return; }
+  auto const path = EntryPath(kind, key);
+  // Write to a temporary and rename so that concurrent runs never see a partial entry
+  auto const tmp = fs::path(path.string() + fmt::format(".{}.tmp", getpid()));
+  try {
+    {
+      HD5::Writer writer(tmp.string());
+      write(writer);
+    }
+    fs::rename(tmp, path);
+    Log::Print("Cached {}", path.string());
+    Evict();
+  } catch (Log::Failure const &e) {
+    Log::Warn("Could not write cache entry {}", path.string());
+    std::error_code ec;
+    fs::remove(tmp, ec);
+  } catch (fs::filesystem_error const &e) {
+    Log::Warn("Could not write cache entry {}: {}", path.string(), e.what());
+    std::error_code ec;
+    fs::remove(tmp, ec);
+  }
+}
+
+} // namespace Cache
+} // namespace rl
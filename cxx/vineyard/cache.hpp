@@ -0,0 +1,46 @@
+#pragma once
+
+#include "io/hd5.hpp"
+#include "types.hpp"
+
+#include <functional>
+#include <optional>
+
+namespace rl {
+
+/*
+ * Content-addressed on-disk cache for expensive, trajectory-dependent precomputation (gridding mappings,
+ * preconditioner weights). Entries are HDF5 files named by a hash of everything the result depends on, so a cache
+ * directory can be shared between scans with the same trajectory. Disabled unless a directory is set.
+ */
+namespace Cache {
+
+void SetDirectory(std::string const &dir); // Empty disables the cache
+void SetBudget(Index const MB);            // Evict least-recently-used entries above this size, 0 = unlimited
+auto Enabled() -> bool;
+
+/*
+ * 64-bit FNV-1a hash. Data is consumed a word at a time, which is plenty to distinguish trajectories and much faster
+ * than byte-at-a-time on large point arrays.
+ */
+struct Key
+{
+  template <typename T> auto add(T const *data, Index const n) -> Key &
+  {
+    return bytes(reinterpret_cast<uint8_t const *>(data), n * sizeof(T));
+  }
+  template <typename T> auto add(T const &v) -> Key & { return add(&v, 1); }
+  auto add(std::string const &s) -> Key &;
+  auto hex() const -> std::string;
+
+private:
+  auto bytes(uint8_t const *data, Index const n) -> Key &;
+
+  uint64_t h_ = 14695981039346656037ULL;
+};
+
+auto Lookup(std::string const &kind, Key const &key) -> std::optional<std::string>;
+void Store(std::string const &kind, Key const &key, std::function<void(HD5::Writer &)> const &write);
+
+} // namespace Cache
+} // namespace rl
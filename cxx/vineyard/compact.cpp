@@ -0,0 +1,19 @@
+#include "compact.hpp"
+
+#include "log.hpp"
+
+namespace rl {
+
+auto ParsePrecision(std::string const &name) -> Precision
+{
+  if (name == "float") {
+    return Precision::Single;
+  } else if (name == "half") {
+    return Precision::Half;
+  } else if (name == "bf16") {
+    return Precision::BFloat16;
+  }
+  Log::Fail("Unknown storage precision {}, must be float/half/bf16", name);
+}
+
+} // namespace rl
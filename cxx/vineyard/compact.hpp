@@ -0,0 +1,79 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <string>
+
+namespace rl {
+
+/*
+ * Storage precision for large, read-mostly complex tensors such as SENSE maps. Half and BFloat16 store the real and
+ * imaginary parts as interleaved 16-bit values, halving the memory and bandwidth. They are widened to float as they
+ * are read inside tensor expressions, so all arithmetic still happens in single precision.
+ */
+enum struct Precision
+{
+  Single,
+  Half,
+  BFloat16
+};
+
+auto ParsePrecision(std::string const &name) -> Precision;
+
+namespace internal {
+struct MakeCx
+{
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE auto operator()(float const re, float const im) const -> Cx { return Cx(re, im); }
+};
+
+template <typename H, int N> auto Widen(Eigen::Tensor<H, N + 1> const &t)
+{
+  return t.template chip<0>(0).template cast<float>().binaryExpr(t.template chip<0>(1).template cast<float>(), MakeCx());
+}
+
+template <typename H, int N> auto Narrow(CxN<N> const &x) -> Eigen::Tensor<H, N + 1>
+{
+  Eigen::Tensor<H, N + 1> t(AddFront(x.dimensions(), 2));
+  t.template chip<0>(0) = x.real().template cast<H>();
+  t.template chip<0>(1) = x.imag().template cast<H>();
+  return t;
+}
+} // namespace internal
+
+template <int N> struct CompactCx
+{
+  CompactCx(CxN<N> const &x, Precision const p = Precision::Single)
+    : precision{p}
+    , dims_{x.dimensions()}
+  {
+    switch (precision) {
+    case Precision::Single: full_ = x; break;
+    case Precision::Half: half_ = internal::Narrow<Eigen::half, N>(x); break;
+    case Precision::BFloat16: bf16_ = internal::Narrow<Eigen::bfloat16, N>(x); break;
+    }
+  }
+
+  /* Call f with the tensor, or with an expression that widens it to Cx */
+  template <typename F> void visit(F &&f) const
+  {
+    switch (precision) {
+    case Precision::Single: f(full_); break;
+    case Precision::Half: f(internal::Widen<Eigen::half, N>(half_)); break;
+    case Precision::BFloat16: f(internal::Widen<Eigen::bfloat16, N>(bf16_)); break;
+    }
+  }
+
+  auto dimensions() const -> Sz<N> const & { return dims_; }
+  auto dimension(Index const i) const -> Index { return dims_[i]; }
+  auto bytes() const -> Index { return Product(dims_) * (precision == Precision::Single ? sizeof(Cx) : 2 * sizeof(Eigen::half)); }
+
+  Precision precision;
+
+private:
+  Sz<N>                                 dims_;
+  CxN<N>                                full_;
+  Eigen::Tensor<Eigen::half, N + 1>     half_;
+  Eigen::Tensor<Eigen::bfloat16, N + 1> bf16_;
+};
+
+} // namespace rl
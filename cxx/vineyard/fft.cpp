@@ -1,6 +1,7 @@
 #include "fft.hpp"
 
 #include "log.hpp"
+#include "profile.hpp"
 #include "tensors.hpp"
 #include "threads.hpp"
 
@@ -49,6 +50,7 @@ private:
   Eigen::ThreadPoolInterface *pool_;
 };
 using Guard = ducc0::detail_threading::ScopedUseThreadPool;
+
 } // namespace internal
 
 template <int NFFT>
@@ -176,6 +178,200 @@ void Adjoint(CxN<ND> &x)
   Adjoint(map);
 }
 
+template <int ND, int NFFT>
+Plan<ND, NFFT>::Plan(Sz<ND> const shape, Sz<NFFT> const dims, Sz<NFFT> const lo, Sz<NFFT> const sz)
+  : shape_{shape}
+  , dims_{dims}
+  , lo_{lo}
+  , sz_{sz}
+  , duccShape_(ND)
+  , duccDims_(NFFT)
+  , duccStride_(ND)
+{
+  Sz<NFFT> fftShape;
+  rsh_.fill(1);
+  brd_ = shape;
+  for (int ii = 0; ii < NFFT; ii++) {
+    fftShape[ii] = shape[dims[ii]];
+    rsh_[dims[ii]] = shape[dims[ii]];
+    brd_[dims[ii]] = 1;
+  }
+  ph_ = PhaseShift(fftShape);
+
+  /* DUCC is row-major, reverse dims */
+  Index stride = 1;
+  for (int ii = 0; ii < ND; ii++) {
+    duccShape_[ND - 1 - ii] = shape[ii];
+    duccStride_[ND - 1 - ii] = stride;
+    stride *= shape[ii];
+  }
+  std::transform(dims.begin(), dims.end(), duccDims_.begin(), [](Index const d) { return ND - 1 - d; });
+  scale_ = 1.f / std::sqrt(static_cast<float>(Product(fftShape)));
+
+  /* The fused shift needs the FFT dims to be the trailing dims so each partner is a contiguous block */
+  fused_ = true;
+  for (int ii = 0; ii < NFFT; ii++) {
+    if (dims[ii] != ND - NFFT + ii || fftShape[ii] % 2) { fused_ = false; }
+  }
+  Log::Debug("FFT Plan shape {} dims {} fused shift {}", shape, dims, fused_);
+}
+
+template <int ND, int NFFT>
+Plan<ND, NFFT>::Plan(Sz<ND> const shape, Sz<NFFT> const dims)
+  : Plan(shape, dims, Sz<NFFT>{}, [&]() {
+    Sz<NFFT> sz;
+    for (int ii = 0; ii < NFFT; ii++) {
+      sz[ii] = shape[dims[ii]];
+    }
+    return sz;
+  }())
+{
+}
+
+template <int ND, int NFFT> auto Plan<ND, NFFT>::phase() const -> CxN<NFFT> const & { return ph_; }
+
+/*
+ *  For even N the shift ramp is ph(n) = c(-1)^n with c = ph(0). Modulating the output of a DFT by (-1)^k is the same
+ *  as circularly shifting its input by N/2, so both ramps can be applied with a single pass that swaps each element
+ *  with its partner half-way round the grid:
+ *    x'(m) = c ph(m + N/2) x(m + N/2)
+ *  The adjoint is identical with the conjugate phases.
+ */
+template <int ND, int NFFT> void Plan<ND, NFFT>::shift(Cx *x, bool const fwd) const
+{
+  Index const blk = std::accumulate(shape_.begin(), shape_.end() - NFFT, Index(1), std::multiplies{});
+  Sz<NFFT>    N, H;
+  Index       inner = 1;
+  for (int ii = 0; ii < NFFT; ii++) {
+    N[ii] = shape_[dims_[ii]];
+    H[ii] = N[ii] / 2;
+    if (ii < NFFT - 1) { inner *= N[ii]; }
+  }
+  Cx const *ph = ph_.data();
+  Cx const  c = fwd ? ph[0] : std::conj(ph[0]);
+  auto      task = [&](Index const iz) {
+    Sz<NFFT> co;
+    co.fill(0);
+    co[NFFT - 1] = iz;
+    for (Index ii = 0; ii < inner; ii++) {
+      Index i = 0, j = 0, str = 1;
+      for (int id = 0; id < NFFT; id++) {
+        i += co[id] * str;
+        j += ((co[id] + H[id]) % N[id]) * str;
+        str *= N[id];
+      }
+      Cx const pi = fwd ? c * ph[i] : c * std::conj(ph[i]);
+      Cx const pj = fwd ? c * ph[j] : c * std::conj(ph[j]);
+      Cx *__restrict a = x + i * blk;
+      Cx *__restrict b = x + j * blk;
+      for (Index ib = 0; ib < blk; ib++) {
+        Cx const t = a[ib];
+        a[ib] = pj * b[ib];
+        b[ib] = pi * t;
+      }
+      for (int id = 0; id < NFFT - 1; id++) {
+        if (++co[id] < N[id]) { break; }
+        co[id] = 0;
+      }
+    }
+  };
+  Threads::For(task, H[NFFT - 1]);
+}
+
+template <int ND, int NFFT> void Plan<ND, NFFT>::forward(Eigen::TensorMap<CxN<ND>> &x) const
+{
+  Profile::Scope scope("FFT forward", 2 * x.size() * sizeof(Cx));
+  internal::ThreadPool pool(Threads::GlobalDevice());
+  internal::Guard      guard(pool);
+  if (fused_) {
+    rl::Log::Debug("FFT Fused Shift");
+    shift(x.data(), true);
+  } else {
+    rl::Log::Debug("FFT Shift");
+    x.device(Threads::GlobalDevice()) = x * ph_.reshape(rsh_).broadcast(brd_);
+  }
+  rl::Log::Debug("DUCC forward FFT shape {} dims {} scale {}", duccShape_, duccDims_, scale_);
+  ducc0::c2c(ducc0::cfmav(x.data(), duccShape_), ducc0::vfmav(x.data(), duccShape_), duccDims_, true, scale_,
+             pool.nthreads());
+  if (!fused_) {
+    rl::Log::Debug("FFT Shift");
+    x.device(Threads::GlobalDevice()) = x * ph_.reshape(rsh_).broadcast(brd_);
+  }
+}
+
+template <int ND, int NFFT> void Plan<ND, NFFT>::adjoint(Eigen::TensorMap<CxN<ND>> &x) const
+{
+  Profile::Scope scope("FFT adjoint", 2 * x.size() * sizeof(Cx));
+  internal::ThreadPool pool(Threads::GlobalDevice());
+  internal::Guard      guard(pool);
+  if (fused_) {
+    rl::Log::Debug("FFT Fused Shift");
+    shift(x.data(), false);
+  } else {
+    rl::Log::Debug("FFT Shift");
+    x.device(Threads::GlobalDevice()) = x / ph_.reshape(rsh_).broadcast(brd_);
+  }
+  rl::Log::Debug("DUCC adjoint FFT shape {} dims {} scale {}", duccShape_, duccDims_, scale_);
+  ducc0::c2c(ducc0::cfmav(x.data(), duccShape_), ducc0::vfmav(x.data(), duccShape_), duccDims_, false, scale_,
+             pool.nthreads());
+  if (!fused_) {
+    rl::Log::Debug("FFT Shift");
+    x.device(Threads::GlobalDevice()) = x / ph_.reshape(rsh_).broadcast(brd_);
+  }
+}
+
+template <int ND, int NFFT> void Plan<ND, NFFT>::forward(CxN<ND> &x) const
+{
+  Eigen::TensorMap<CxN<ND>> map(x.data(), x.dimensions());
+  forward(map);
+}
+
+template <int ND, int NFFT> void Plan<ND, NFFT>::adjoint(CxN<ND> &x) const
+{
+  Eigen::TensorMap<CxN<ND>> map(x.data(), x.dimensions());
+  adjoint(map);
+}
+
+/*
+ *  Run the FFT one dimension at a time, restricting the dimensions that are still zero-padded (forward) or that will be
+ *  cropped (adjoint) to the region [lo, lo + sz). For a 2x oversampled 3D grid this skips 3/4 of the first pass and 1/2
+ *  of the second (reversed for the adjoint).
+ */
+template <int ND, int NFFT> void Plan<ND, NFFT>::pruned(Cx *x, bool const fwd) const
+{
+  internal::ThreadPool pool(Threads::GlobalDevice());
+  internal::Guard      guard(pool);
+  for (int ik = 0; ik < NFFT; ik++) {
+    auto shape = duccShape_;
+    Cx  *ptr = x;
+    for (int ij = 0; ij < NFFT; ij++) {
+      if ((fwd && ij > ik) || (!fwd && ij < ik)) {
+        shape[duccDims_[ij]] = sz_[ij];
+        ptr += lo_[ij] * duccStride_[duccDims_[ij]];
+      }
+    }
+    rl::Log::Debug("DUCC pruned {} FFT dim {} shape {}", fwd ? "forward" : "adjoint", dims_[ik], shape);
+    ducc0::c2c(ducc0::cfmav(ptr, shape, duccStride_), ducc0::vfmav(ptr, shape, duccStride_), {duccDims_[ik]}, fwd,
+               ik == 0 ? scale_ : 1.f, pool.nthreads());
+  }
+}
+
+template <int ND, int NFFT> void Plan<ND, NFFT>::forwardPruned(Eigen::TensorMap<CxN<ND>> &x) const
+{
+  Profile::Scope scope("FFT forward pruned", 2 * x.size() * sizeof(Cx));
+  pruned(x.data(), true);
+  rl::Log::Debug("FFT Shift");
+  x.device(Threads::GlobalDevice()) = x * ph_.reshape(rsh_).broadcast(brd_);
+}
+
+template <int ND, int NFFT> void Plan<ND, NFFT>::adjointPruned(Eigen::TensorMap<CxN<ND>> &x) const
+{
+  Profile::Scope scope("FFT adjoint pruned", 2 * x.size() * sizeof(Cx));
+  rl::Log::Debug("FFT Shift");
+  x.device(Threads::GlobalDevice()) = x / ph_.reshape(rsh_).broadcast(brd_);
+  pruned(x.data(), false);
+}
+
 template auto PhaseShift<1>(Sz1 const) -> Cx1;
 template auto PhaseShift<2>(Sz2 const) -> Cx2;
 template auto PhaseShift<3>(Sz3 const) -> Cx3;
@@ -204,5 +400,14 @@ template void Adjoint<1>(Cx1 &);
 template void Adjoint<2>(Cx2 &);
 template void Adjoint<3>(Cx3 &);
 
+template struct Plan<3, 1>;
+template struct Plan<3, 2>;
+template struct Plan<4, 1>;
+template struct Plan<4, 2>;
+template struct Plan<4, 3>;
+template struct Plan<5, 2>;
+template struct Plan<5, 3>;
+template struct Plan<6, 3>;
+
 } // namespace FFT
 } // namespace rl
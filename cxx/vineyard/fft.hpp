@@ -20,6 +20,42 @@ template <int ND> void           Adjoint(Eigen::TensorMap<CxN<ND>> &data);
 template <int ND, int NFFT> void Adjoint(CxN<ND> &data, Sz<NFFT> const fftDims, CxN<NFFT> const &ph);
 template <int ND> void           Adjoint(CxN<ND> &data);
 
+/*
+ * A centred FFT over a fixed data shape. Caches the phase ramps and DUCC shape descriptors so callers do not need to
+ * carry them around (DUCC caches its own twiddle plans). If the FFT dimensions are trailing and even the FFT-shift is
+ * done in one fused swap-and-modulate pass instead of two full multiplications.
+ *
+ * The pruned transforms are for zero-padded data. Only the region [lo, lo + sz) of the FFT dimensions is non-zero on
+ * input to forwardPruned, and only that region of the output of adjointPruned is required. The phase ramp on that
+ * side of the transform is NOT applied and must be folded in by the caller (e.g. into the apodization).
+ */
+template <int ND, int NFFT> struct Plan
+{
+  Plan(Sz<ND> const shape, Sz<NFFT> const dims);
+  Plan(Sz<ND> const shape, Sz<NFFT> const dims, Sz<NFFT> const lo, Sz<NFFT> const sz);
+
+  void forward(Eigen::TensorMap<CxN<ND>> &x) const;
+  void adjoint(Eigen::TensorMap<CxN<ND>> &x) const;
+  void forward(CxN<ND> &x) const;
+  void adjoint(CxN<ND> &x) const;
+  void forwardPruned(Eigen::TensorMap<CxN<ND>> &x) const;
+  void adjointPruned(Eigen::TensorMap<CxN<ND>> &x) const;
+
+  auto phase() const -> CxN<NFFT> const &;
+
+private:
+  void shift(Cx *x, bool const fwd) const;
+  void pruned(Cx *x, bool const fwd) const;
+
+  Sz<ND>                 shape_, rsh_, brd_;
+  Sz<NFFT>               dims_, lo_, sz_;
+  CxN<NFFT>              ph_;
+  std::vector<size_t>    duccShape_, duccDims_;
+  std::vector<ptrdiff_t> duccStride_;
+  float                  scale_;
+  bool                   fused_;
+};
+
 } // namespace FFT
 
 } // namespace rl
@@ -109,6 +109,7 @@ template <typename T> auto Reader::readTensor(std::string const &name) const ->
 }
 
 template auto Reader::readTensor<I1>(std::string const &) const -> I1;
+template auto Reader::readTensor<I2>(std::string const &) const -> I2;
 template auto Reader::readTensor<Re1>(std::string const &) const -> Re1;
 template auto Reader::readTensor<Re2>(std::string const &) const -> Re2;
 template auto Reader::readTensor<Re3>(std::string const &) const -> Re3;
@@ -124,6 +124,7 @@ void Writer::writeTensor(std::string const &name, Sz<N> const &shape, Scalar con
 }
 
 template void Writer::writeTensor<Index, 1>(std::string const &, Sz<1> const &, Index const *, DimensionNames<1> const &);
+template void Writer::writeTensor<Index, 2>(std::string const &, Sz<2> const &, Index const *, DimensionNames<2> const &);
 template void Writer::writeTensor<float, 1>(std::string const &, Sz<1> const &, float const *, DimensionNames<1> const &);
 template void Writer::writeTensor<float, 2>(std::string const &, Sz<2> const &, float const *, DimensionNames<2> const &);
 template void Writer::writeTensor<float, 3>(std::string const &, Sz<3> const &, float const *, DimensionNames<3> const &);
@@ -5,6 +5,24 @@
 #include <fmt/ranges.h>
 #include <fmt/ostream.h>
 
+/*
+ * Compile the hot kernels for multiple instruction sets, picked at load time by CPU feature (GCC/x86-64 only)
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define KERNEL_SIMD_CLONES __attribute__((target_clones("default", "avx2", "avx512f")))
+#else
+#define KERNEL_SIMD_CLONES
+#endif
+
+/*
+ * The loop nests are shared between weight sources, so make sure they are inlined into each (possibly cloned) caller
+ */
+#if defined(__GNUC__)
+#define KERNEL_INLINE __attribute__((always_inline)) inline
+#else
+#define KERNEL_INLINE inline
+#endif
+
 namespace rl {
 
 template <int ND, int W> struct KernelSizes
@@ -26,6 +44,55 @@ template <int W> struct KernelSizes<3, W>
   using Type = Eigen::Sizes<W, W, W>;
 };
 
+/*
+ * Sources of kernel weights for the spread/gather loop nests, called with the kernel indices (first dimension fastest).
+ * EvaluatedWeights calls the kernel function. The squared distance along each dimension is only calculated once per
+ * point. TabulatedWeights reads W^ND precomputed values in the same order.
+ */
+template <typename Func, int ND> struct EvaluatedWeights
+{
+  constexpr static int   W = Func::PadWidth;
+  constexpr static float HW = Func::Width / 2.f;
+  constexpr static float L = (0.5f - W / 2.f);
+
+  Func const &f;
+  float const scale;
+  float       z[ND][W];
+
+  EvaluatedWeights(Func const &f_, float const s, Eigen::Matrix<float, ND, 1> const &p)
+    : f{f_}
+    , scale{s}
+  {
+    for (Index id = 0; id < ND; id++) {
+      for (Index ii = 0; ii < W; ii++) {
+        float const d = ((ii + L) - p[id]) / HW;
+        z[id][ii] = d * d;
+      }
+    }
+  }
+
+  KERNEL_INLINE auto operator()(Index const i0, Index const i1 = 0, Index const i2 = 0) const -> float
+  {
+    if constexpr (ND == 1) {
+      return f(z[0][i0]) * scale;
+    } else if constexpr (ND == 2) {
+      return f(z[0][i0] + z[1][i1]) * scale;
+    } else {
+      return f(z[0][i0] + z[1][i1] + z[2][i2]) * scale;
+    }
+  }
+};
+
+template <int W> struct TabulatedWeights
+{
+  float const *k;
+
+  KERNEL_INLINE auto operator()(Index const i0, Index const i1 = 0, Index const i2 = 0) const -> float
+  {
+    return k[(i2 * W + i1) * W + i0];
+  }
+};
+
 template <typename Scalar, int ND, typename Func> struct FixedKernel
 {
 };
@@ -38,8 +105,10 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 1, Func>
   using OneD = Eigen::TensorFixedSize<float, Eigen::Sizes<W>>;
   using Tensor = Eigen::TensorFixedSize<float, typename KernelSizes<1, W>::Type>;
   using Point = Eigen::Matrix<float, 1, 1>;
+  using Evaluated = EvaluatedWeights<Func, 1>;
+  using Tabulated = TabulatedWeights<W>;
 
-  static inline auto K(Func const &f, float const scale, Point const &p) -> Tensor
+  static inline auto K(Func const &f, float const  scale, Point const &p) -> Tensor
   {
     Tensor k;
     for (Index i0 = 0; i0 < W; i0++) {
@@ -49,18 +118,96 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 1, Func>
     return k;
   }
 
-  static inline void Spread(Func const                     &f,
-                            float const                     scale,
-                            std::array<int16_t, 1> const   &c,
-                            Point const                    &p,
-                            Eigen::Tensor<Scalar, 1> const &y,
-                            Eigen::Tensor<Scalar, 3>       &x)
+  static inline void Spread(Func const                                             &f,
+                            float const                                             scale,
+                            std::array<int16_t, 1> const                           &c,
+                            Point const                                            &p,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3>>             &x)
+  {
+    SpreadWith(Evaluated(f, scale, p), c, y, x);
+  }
+
+  static inline void Spread(Func const                                             &f,
+                            float const                                             scale,
+                            std::array<int16_t, 1> const                           &c,
+                            Point const                                            &p,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3>>             &x)
+  {
+    SpreadWith(Evaluated(f, scale, p), c, b, y, x);
+  }
+
+  static inline void Gather(Func const                                             &f,
+                            float const                                             scale,
+                            std::array<int16_t, 1> const                           &c,
+                            Point const                                            &p,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3> const> const &x,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Evaluated(f, scale, p), c, x, y);
+  }
+
+  static inline void Gather(Func const                                             &f,
+                            float const                                             scale,
+                            std::array<int16_t, 1> const                           &c,
+                            Point const                                            &p,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3> const> const &x,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Evaluated(f, scale, p), c, b, x, y);
+  }
+
+  /*
+   * Versions using precomputed weights, W^1 contiguous values with the first dimension fastest
+   */
+  static inline void Spread(float const                                            *k,
+                            std::array<int16_t, 1> const                           &c,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3>>             &x)
+  {
+    SpreadWith(Tabulated{k}, c, y, x);
+  }
+
+  static inline void Spread(float const                                            *k,
+                            std::array<int16_t, 1> const                           &c,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3>>             &x)
+  {
+    SpreadWith(Tabulated{k}, c, b, y, x);
+  }
+
+  static inline void Gather(float const                                            *k,
+                            std::array<int16_t, 1> const                           &c,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3> const> const &x,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Tabulated{k}, c, x, y);
+  }
+
+  static inline void Gather(float const                                            *k,
+                            std::array<int16_t, 1> const                           &c,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3> const> const &x,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Tabulated{k}, c, b, x, y);
+  }
+
+private:
+  template <typename Weights>
+  static KERNEL_INLINE void SpreadWith(Weights const                                          &w,
+                                       std::array<int16_t, 1> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 3>>             &x)
   {
     Index const nC = x.dimension(1);
     for (Index i0 = 0; i0 < W; i0++) {
       Index const ii0 = i0 + c[0] - W / 2;
-      float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-      float const kval = f(z0) * scale;
+      float const kval = w(i0);
       for (Index ic = 0; ic < nC; ic++) {
         Scalar const yval = y(ic) * kval;
         x(0, ic, ii0) += yval;
@@ -68,13 +215,12 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 1, Func>
     }
   }
 
-  static inline void Spread(Func const                     &f,
-                            float const                     scale,
-                            std::array<int16_t, 1> const   &c,
-                            Point const                    &p,
-                            Eigen::Tensor<Scalar, 1> const &b,
-                            Eigen::Tensor<Scalar, 1> const &y,
-                            Eigen::Tensor<Scalar, 3>       &x)
+  template <typename Weights>
+  static KERNEL_INLINE void SpreadWith(Weights const                                          &w,
+                                       std::array<int16_t, 1> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 3>>             &x)
   {
     assert(x.dimension(0) == b.dimension(0));
     assert(x.dimension(1) == y.dimension(0));
@@ -82,43 +228,39 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 1, Func>
     Index const nC = x.dimension(1);
     for (Index i0 = 0; i0 < W; i0++) {
       Index const ii0 = i0 + c[0] - W / 2;
-      float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-      float const kval = f(z0) * scale;
+      float const kval = w(i0);
       for (Index ic = 0; ic < nC; ic++) {
         Scalar const yval = y(ic) * kval;
         for (Index ib = 0; ib < nB; ib++) {
-          Scalar const bval = yval * b(ib);
+          Scalar const bval = yval * Eigen::numext::conj(b(ib));
           x(ib, ic, ii0) += bval;
         }
       }
     }
   }
 
-  static inline void Gather(Func const                                             &f,
-                            float const                                             scale,
-                            std::array<int16_t, 1> const                           &c,
-                            Point const                                            &p,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3> const> const &x,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  template <typename Weights>
+  static KERNEL_INLINE void GatherWith(Weights const                                          &w,
+                                       std::array<int16_t, 1> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 3> const> const &x,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
   {
     Index const nC = x.dimension(1);
     for (Index i0 = 0; i0 < W; i0++) {
       Index const ii0 = i0 + c[0] - (W - 1) / 2;
-      float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-      float const kval = f(z0) * scale;
+      float const kval = w(i0);
       for (Index ic = 0; ic < nC; ic++) {
         y(ic) += x(0, ic, ii0) * kval;
       }
     }
   }
 
-  static inline void Gather(Func const                                             &f,
-                            float const                                             scale,
-                            std::array<int16_t, 1> const                           &c,
-                            Point const                                            &p,
-                            Eigen::Tensor<Scalar, 1> const                         &b,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 3> const> const &x,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  template <typename Weights>
+  static KERNEL_INLINE void GatherWith(Weights const                                          &w,
+                                       std::array<int16_t, 1> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 3> const> const &x,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
   {
     assert(x.dimension(0) == b.dimension(0));
     assert(x.dimension(1) == y.dimension(0));
@@ -126,8 +268,7 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 1, Func>
     Index const nC = x.dimension(1);
     for (Index i0 = 0; i0 < W; i0++) {
       Index const ii0 = i0 + c[0] - (W - 1) / 2;
-      float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-      float const kval = f(z0) * scale;
+      float const kval = w(i0);
       for (Index ic = 0; ic < nC; ic++) {
         for (Index ib = 0; ib < nB; ib++) {
           y(ic) += x(ib, ic, ii0) * b(ib) * kval;
@@ -145,8 +286,10 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 2, Func>
   using OneD = Eigen::TensorFixedSize<float, Eigen::Sizes<W>>;
   using Tensor = Eigen::TensorFixedSize<float, typename KernelSizes<2, W>::Type>;
   using Point = Eigen::Matrix<float, 2, 1>;
+  using Evaluated = EvaluatedWeights<Func, 2>;
+  using Tabulated = TabulatedWeights<W>;
 
-  static inline auto K(Func const &f, float const scale, Point const &p) -> Tensor
+  static inline auto K(Func const &f, float const  scale, Point const &p) -> Tensor
   {
     Tensor k;
     for (Index i1 = 0; i1 < W; i1++) {
@@ -159,21 +302,98 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 2, Func>
     return k;
   }
 
-  static inline void Spread(Func const                     &f,
-                            float const                     scale,
-                            std::array<int16_t, 2> const   &c,
-                            Point const                    &p,
-                            Eigen::Tensor<Scalar, 1> const &y,
-                            Eigen::Tensor<Scalar, 4>       &x)
+  static inline void Spread(Func const                                             &f,
+                            float const                                             scale,
+                            std::array<int16_t, 2> const                           &c,
+                            Point const                                            &p,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4>>             &x)
+  {
+    SpreadWith(Evaluated(f, scale, p), c, y, x);
+  }
+
+  static inline void Spread(Func const                                             &f,
+                            float const                                             scale,
+                            std::array<int16_t, 2> const                           &c,
+                            Point const                                            &p,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4>>             &x)
+  {
+    SpreadWith(Evaluated(f, scale, p), c, b, y, x);
+  }
+
+  static inline void Gather(Func const                                             &f,
+                            float const                                             scale,
+                            std::array<int16_t, 2> const                           &c,
+                            Point const                                            &p,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4> const> const &x,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Evaluated(f, scale, p), c, x, y);
+  }
+
+  static inline void Gather(Func const                                             &f,
+                            float const                                             scale,
+                            std::array<int16_t, 2> const                           &c,
+                            Point const                                            &p,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4> const> const &x,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Evaluated(f, scale, p), c, b, x, y);
+  }
+
+  /*
+   * Versions using precomputed weights, W^2 contiguous values with the first dimension fastest
+   */
+  static inline void Spread(float const                                            *k,
+                            std::array<int16_t, 2> const                           &c,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4>>             &x)
+  {
+    SpreadWith(Tabulated{k}, c, y, x);
+  }
+
+  static inline void Spread(float const                                            *k,
+                            std::array<int16_t, 2> const                           &c,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4>>             &x)
+  {
+    SpreadWith(Tabulated{k}, c, b, y, x);
+  }
+
+  static inline void Gather(float const                                            *k,
+                            std::array<int16_t, 2> const                           &c,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4> const> const &x,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Tabulated{k}, c, x, y);
+  }
+
+  static inline void Gather(float const                                            *k,
+                            std::array<int16_t, 2> const                           &c,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4> const> const &x,
+                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Tabulated{k}, c, b, x, y);
+  }
+
+private:
+  template <typename Weights>
+  static KERNEL_INLINE void SpreadWith(Weights const                                          &w,
+                                       std::array<int16_t, 2> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 4>>             &x)
   {
     Index const nC = x.dimension(1);
     for (Index i1 = 0; i1 < W; i1++) {
       Index const ii1 = i1 + c[1] - W / 2;
-      float const z1 = pow(((i1 + L) - p[1]) / HW, 2);
       for (Index i0 = 0; i0 < W; i0++) {
         Index const ii0 = i0 + c[0] - W / 2;
-        float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-        float const kval = f(z0 + z1) * scale;
+        float const kval = w(i0, i1);
         for (Index ic = 0; ic < nC; ic++) {
           Scalar const yval = y(ic) * kval;
           x(0, ic, ii0, ii1) += yval;
@@ -182,13 +402,12 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 2, Func>
     }
   }
 
-  static inline void Spread(Func const                     &f,
-                            float const                     scale,
-                            std::array<int16_t, 2> const   &c,
-                            Point const                    &p,
-                            Eigen::Tensor<Scalar, 1> const &b,
-                            Eigen::Tensor<Scalar, 1> const &y,
-                            Eigen::Tensor<Scalar, 4>       &x)
+  template <typename Weights>
+  static KERNEL_INLINE void SpreadWith(Weights const                                          &w,
+                                       std::array<int16_t, 2> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 4>>             &x)
   {
     assert(x.dimension(0) == b.dimension(0));
     assert(x.dimension(1) == y.dimension(0));
@@ -196,15 +415,13 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 2, Func>
     Index const nC = x.dimension(1);
     for (Index i1 = 0; i1 < W; i1++) {
       Index const ii1 = i1 + c[1] - W / 2;
-      float const z1 = pow(((i1 + L) - p[1]) / HW, 2);
       for (Index i0 = 0; i0 < W; i0++) {
         Index const ii0 = i0 + c[0] - W / 2;
-        float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-        float const kval = f(z0 + z1) * scale;
+        float const kval = w(i0, i1);
         for (Index ic = 0; ic < nC; ic++) {
           Scalar const yval = y(ic) * kval;
           for (Index ib = 0; ib < nB; ib++) {
-            Scalar const bval = yval * b(ib);
+            Scalar const bval = yval * Eigen::numext::conj(b(ib));
             x(ib, ic, ii0, ii1) += bval;
           }
         }
@@ -212,21 +429,18 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 2, Func>
     }
   }
 
-  static inline void Gather(Func const                                             &f,
-                            float const                                             scale,
-                            std::array<int16_t, 2> const                           &c,
-                            Point const                                            &p,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4> const> const &x,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  template <typename Weights>
+  static KERNEL_INLINE void GatherWith(Weights const                                          &w,
+                                       std::array<int16_t, 2> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 4> const> const &x,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
   {
     Index const nC = x.dimension(1);
     for (Index i1 = 0; i1 < W; i1++) {
       Index const ii1 = i1 + c[1] - (W - 1) / 2;
-      float const z1 = pow(((i1 + L) - p[1]) / HW, 2);
       for (Index i0 = 0; i0 < W; i0++) {
         Index const ii0 = i0 + c[0] - (W - 1) / 2;
-        float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-        float const kval = f(z0 + z1) * scale;
+        float const kval = w(i0, i1);
         for (Index ic = 0; ic < nC; ic++) {
           y(ic) += x(0, ic, ii0, ii1) * kval;
         }
@@ -234,13 +448,12 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 2, Func>
     }
   }
 
-  static inline void Gather(Func const                                             &f,
-                            float const                                             scale,
-                            std::array<int16_t, 2> const                           &c,
-                            Point const                                            &p,
-                            Eigen::Tensor<Scalar, 1> const                         &b,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 4> const> const &x,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  template <typename Weights>
+  static KERNEL_INLINE void GatherWith(Weights const                                          &w,
+                                       std::array<int16_t, 2> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 4> const> const &x,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
   {
     assert(x.dimension(0) == b.dimension(0));
     assert(x.dimension(1) == y.dimension(0));
@@ -248,11 +461,9 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 2, Func>
     Index const nC = x.dimension(1);
     for (Index i1 = 0; i1 < W; i1++) {
       Index const ii1 = i1 + c[1] - (W - 1) / 2;
-      float const z1 = pow(((i1 + L) - p[1]) / HW, 2);
       for (Index i0 = 0; i0 < W; i0++) {
         Index const ii0 = i0 + c[0] - (W - 1) / 2;
-        float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-        float const kval = f(z0 + z1) * scale;
+        float const kval = w(i0, i1);
         for (Index ic = 0; ic < nC; ic++) {
           for (Index ib = 0; ib < nB; ib++) {
             y(ic) += x(ib, ic, ii0, ii1) * b(ib) * kval;
@@ -263,6 +474,11 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 2, Func>
   }
 };
 
+/*
+ * The 3D kernels are the hot-path for most recons, so are written with raw pointers into the channel/basis
+ * dimensions, which are contiguous, so that the innermost loops auto-vectorise. Where supported they are compiled
+ * for several instruction sets and the best is chosen at runtime.
+ */
 template <typename Scalar, typename Func> struct FixedKernel<Scalar, 3, Func>
 {
   constexpr static int   W = Func::PadWidth;
@@ -271,8 +487,10 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 3, Func>
   using OneD = Eigen::TensorFixedSize<float, Eigen::Sizes<W>>;
   using Tensor = Eigen::TensorFixedSize<float, typename KernelSizes<3, W>::Type>;
   using Point = Eigen::Matrix<float, 3, 1>;
+  using Evaluated = EvaluatedWeights<Func, 3>;
+  using Tabulated = TabulatedWeights<W>;
 
-  static inline auto K(Func const &f, float const scale, Point const &p) -> Tensor
+  static inline auto K(Func const &f, float const  scale, Point const &p) -> Tensor
   {
     Tensor k;
     for (Index i2 = 0; i2 < W; i2++) {
@@ -288,60 +506,136 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 3, Func>
     return k;
   }
 
-  static inline void Spread(Func const                     &f,
-                            float const                     scale,
-                            std::array<int16_t, 3> const   &c,
-                            Point const                    &p,
-                            Eigen::Tensor<Scalar, 1> const &y,
-                            Eigen::Tensor<Scalar, 5>       &x)
+  KERNEL_SIMD_CLONES static void Spread(Func const                                             &f,
+                                        float const                                             scale,
+                                        std::array<int16_t, 3> const                           &c,
+                                        Point const                                            &p,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 5>>             &x)
+  {
+    SpreadWith(Evaluated(f, scale, p), c, y, x);
+  }
+
+  KERNEL_SIMD_CLONES static void Spread(Func const                                             &f,
+                                        float const                                             scale,
+                                        std::array<int16_t, 3> const                           &c,
+                                        Point const                                            &p,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 5>>             &x)
+  {
+    SpreadWith(Evaluated(f, scale, p), c, b, y, x);
+  }
+
+  KERNEL_SIMD_CLONES static void Gather(Func const                                             &f,
+                                        float const                                             scale,
+                                        std::array<int16_t, 3> const                           &c,
+                                        Point const                                            &p,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 5> const> const &x,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Evaluated(f, scale, p), c, x, y);
+  }
+
+  KERNEL_SIMD_CLONES static void Gather(Func const                                             &f,
+                                        float const                                             scale,
+                                        std::array<int16_t, 3> const                           &c,
+                                        Point const                                            &p,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 5> const> const &x,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Evaluated(f, scale, p), c, b, x, y);
+  }
+
+  /*
+   * Versions using precomputed weights, W^3 contiguous values with the first dimension fastest
+   */
+  KERNEL_SIMD_CLONES static void Spread(float const                                            *k,
+                                        std::array<int16_t, 3> const                           &c,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 5>>             &x)
+  {
+    SpreadWith(Tabulated{k}, c, y, x);
+  }
+
+  KERNEL_SIMD_CLONES static void Spread(float const                                            *k,
+                                        std::array<int16_t, 3> const                           &c,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 5>>             &x)
+  {
+    SpreadWith(Tabulated{k}, c, b, y, x);
+  }
+
+  KERNEL_SIMD_CLONES static void Gather(float const                                            *k,
+                                        std::array<int16_t, 3> const                           &c,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 5> const> const &x,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Tabulated{k}, c, x, y);
+  }
+
+  KERNEL_SIMD_CLONES static void Gather(float const                                            *k,
+                                        std::array<int16_t, 3> const                           &c,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 5> const> const &x,
+                                        Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  {
+    GatherWith(Tabulated{k}, c, b, x, y);
+  }
+
+private:
+  template <typename Weights>
+  static KERNEL_INLINE void SpreadWith(Weights const                                          &w,
+                                       std::array<int16_t, 3> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 5>>             &x)
   {
     Index const nC = x.dimension(1);
+    Index const st = x.dimension(0) * nC;
+    Scalar const *__restrict yp = y.data();
     for (Index i2 = 0; i2 < W; i2++) {
       Index const ii2 = i2 + c[2] - W / 2;
-      float const z2 = pow(((i2 + L) - p[2]) / HW, 2);
       for (Index i1 = 0; i1 < W; i1++) {
         Index const ii1 = i1 + c[1] - W / 2;
-        float const z1 = pow(((i1 + L) - p[1]) / HW, 2);
+        Scalar     *xr = &x(0, 0, c[0] - W / 2, ii1, ii2);
         for (Index i0 = 0; i0 < W; i0++) {
-          Index const ii0 = i0 + c[0] - W / 2;
-          float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-          float const kval = f(z0 + z1 + z2) * scale;
+          float const          kval = w(i0, i1, i2);
+          Scalar *__restrict xp = xr + i0 * st;
           for (Index ic = 0; ic < nC; ic++) {
-            Scalar const yval = y(ic) * kval;
-            x(0, ic, ii0, ii1, ii2) += yval;
+            xp[ic] += yp[ic] * kval;
           }
         }
       }
     }
   }
 
-  static inline void Spread(Func const                     &f,
-                            float const                     scale,
-                            std::array<int16_t, 3> const   &c,
-                            Point const                    &p,
-                            Eigen::Tensor<Scalar, 1> const &b,
-                            Eigen::Tensor<Scalar, 1> const &y,
-                            Eigen::Tensor<Scalar, 5>       &x)
+  template <typename Weights>
+  static KERNEL_INLINE void SpreadWith(Weights const                                          &w,
+                                       std::array<int16_t, 3> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 5>>             &x)
   {
     assert(x.dimension(0) == b.dimension(0));
     assert(x.dimension(1) == y.dimension(0));
     Index const nB = x.dimension(0);
     Index const nC = x.dimension(1);
+    Scalar const *__restrict yp = y.data();
+    Scalar const *__restrict bp = b.data();
     for (Index i2 = 0; i2 < W; i2++) {
       Index const ii2 = i2 + c[2] - W / 2;
-      float const z2 = pow(((i2 + L) - p[2]) / HW, 2);
       for (Index i1 = 0; i1 < W; i1++) {
         Index const ii1 = i1 + c[1] - W / 2;
-        float const z1 = pow(((i1 + L) - p[1]) / HW, 2);
+        Scalar     *xr = &x(0, 0, c[0] - W / 2, ii1, ii2);
         for (Index i0 = 0; i0 < W; i0++) {
-          Index const ii0 = i0 + c[0] - W / 2;
-          float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-          float const kval = f(z0 + z1 + z2) * scale;
+          float const          kval = w(i0, i1, i2);
+          Scalar *__restrict xp = xr + i0 * nB * nC;
           for (Index ic = 0; ic < nC; ic++) {
-            Scalar const yval = y(ic) * kval;
+            Scalar const yval = yp[ic] * kval;
             for (Index ib = 0; ib < nB; ib++) {
-              Scalar const bval = yval * b(ib);
-              x(ib, ic, ii0, ii1, ii2) += bval;
+              xp[ic * nB + ib] += yval * Eigen::numext::conj(bp[ib]);
             }
           }
         }
@@ -349,58 +643,58 @@ template <typename Scalar, typename Func> struct FixedKernel<Scalar, 3, Func>
     }
   }
 
-  static inline void Gather(Func const                                             &f,
-                            float const                                             scale,
-                            std::array<int16_t, 3> const                           &c,
-                            Point const                                            &p,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 5> const> const &x,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  template <typename Weights>
+  static KERNEL_INLINE void GatherWith(Weights const                                          &w,
+                                       std::array<int16_t, 3> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 5> const> const &x,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
   {
     Index const nC = x.dimension(1);
+    Index const st = x.dimension(0) * nC;
+    Scalar *__restrict yp = y.data();
     for (Index i2 = 0; i2 < W; i2++) {
       Index const ii2 = i2 + c[2] - (W - 1) / 2;
-      float const z2 = pow(((i2 + L) - p[2]) / HW, 2);
       for (Index i1 = 0; i1 < W; i1++) {
-        Index const ii1 = i1 + c[1] - (W - 1) / 2;
-        float const z1 = pow(((i1 + L) - p[1]) / HW, 2);
+        Index const   ii1 = i1 + c[1] - (W - 1) / 2;
+        Scalar const *xr = &x(0, 0, c[0] - (W - 1) / 2, ii1, ii2);
         for (Index i0 = 0; i0 < W; i0++) {
-          Index const ii0 = i0 + c[0] - (W - 1) / 2;
-          float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-          float const kval = f(z0 + z1 + z2) * scale;
+          float const                kval = w(i0, i1, i2);
+          Scalar const *__restrict xp = xr + i0 * st;
           for (Index ic = 0; ic < nC; ic++) {
-            y(ic) += x(0, ic, ii0, ii1, ii2) * kval;
+            yp[ic] += xp[ic] * kval;
           }
         }
       }
     }
   }
 
-  static inline void Gather(Func const                                             &f,
-                            float const                                             scale,
-                            std::array<int16_t, 3> const                           &c,
-                            Point const                                            &p,
-                            Eigen::Tensor<Scalar, 1> const                         &b,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 5> const> const &x,
-                            Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
+  template <typename Weights>
+  static KERNEL_INLINE void GatherWith(Weights const                                          &w,
+                                       std::array<int16_t, 3> const                           &c,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 5> const> const &x,
+                                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>             &y)
   {
     assert(x.dimension(0) == b.dimension(0));
     assert(x.dimension(1) == y.dimension(0));
     Index const nB = x.dimension(0);
     Index const nC = x.dimension(1);
+    Scalar *__restrict yp = y.data();
+    Scalar const *__restrict bp = b.data();
     for (Index i2 = 0; i2 < W; i2++) {
       Index const ii2 = i2 + c[2] - (W - 1) / 2;
-      float const z2 = pow(((i2 + L) - p[2]) / HW, 2);
       for (Index i1 = 0; i1 < W; i1++) {
-        Index const ii1 = i1 + c[1] - (W - 1) / 2;
-        float const z1 = pow(((i1 + L) - p[1]) / HW, 2);
+        Index const   ii1 = i1 + c[1] - (W - 1) / 2;
+        Scalar const *xr = &x(0, 0, c[0] - (W - 1) / 2, ii1, ii2);
         for (Index i0 = 0; i0 < W; i0++) {
-          Index const ii0 = i0 + c[0] - (W - 1) / 2;
-          float const z0 = pow(((i0 + L) - p[0]) / HW, 2);
-          float const kval = f(z0 + z1 + z2) * scale;
+          float const                kval = w(i0, i1, i2);
+          Scalar const *__restrict xp = xr + i0 * nB * nC;
           for (Index ic = 0; ic < nC; ic++) {
+            Scalar yval = 0;
             for (Index ib = 0; ib < nB; ib++) {
-              y(ic) += x(ib, ic, ii0, ii1, ii2) * b(ib) * kval;
+              yval += xp[ic * nB + ib] * bp[ib];
             }
+            yp[ic] += yval * kval;
           }
         }
       }
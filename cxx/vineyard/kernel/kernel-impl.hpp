@@ -5,6 +5,7 @@
 
 #include "expsemi.hpp"
 #include "kaiser.hpp"
+#include "tabulated.hpp"
 
 #include "tensors.hpp"
 
@@ -47,19 +48,19 @@ template <typename Scalar, int ND, typename Func> struct Kernel final : KernelBa
     return k;
   }
 
-  void spread(std::array<int16_t, ND> const   c,
-              Point const                    &p,
-              Eigen::Tensor<Scalar, 1> const &y,
-              Eigen::Tensor<Scalar, ND + 2>  &x) const final
+  void spread(std::array<int16_t, ND> const                           c,
+              Point const                                            &p,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const final
   {
     FixedKernel<Scalar, ND, Func>::Spread(f, scale, c, p, y, x);
   }
 
-  void spread(std::array<int16_t, ND> const   c,
-              Point const                    &p,
-              Eigen::Tensor<Scalar, 1> const &b,
-              Eigen::Tensor<Scalar, 1> const &y,
-              Eigen::Tensor<Scalar, ND + 2>  &x) const final
+  void spread(std::array<int16_t, ND> const                           c,
+              Point const                                            &p,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const final
   {
     FixedKernel<Scalar, ND, Func>::Spread(f, scale, c, p, b, y, x);
   }
@@ -74,16 +75,67 @@ template <typename Scalar, int ND, typename Func> struct Kernel final : KernelBa
 
   void gather(std::array<int16_t, ND> const                                c,
               Point const                                                 &p,
-              Eigen::Tensor<Scalar, 1> const                              &b,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const      &b,
               Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
               Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const final
   {
     FixedKernel<Scalar, ND, Func>::Gather(f, scale, c, p, b, x, y);
   }
+
+  void weights(Point const &p, float *k) const final
+  {
+    Tensor const kp = FixedKernel<Scalar, ND, Func>::K(f, scale, p);
+    std::copy_n(kp.data(), kp.size(), k);
+  }
+
+  void spread(std::array<int16_t, ND> const                           c,
+              float const                                            *k,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const final
+  {
+    FixedKernel<Scalar, ND, Func>::Spread(k, c, y, x);
+  }
+
+  void spread(std::array<int16_t, ND> const                           c,
+              float const                                            *k,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const final
+  {
+    FixedKernel<Scalar, ND, Func>::Spread(k, c, b, y, x);
+  }
+
+  void gather(std::array<int16_t, ND> const                                c,
+              float const                                                 *k,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const final
+  {
+    FixedKernel<Scalar, ND, Func>::Gather(k, c, x, y);
+  }
+
+  void gather(std::array<int16_t, ND> const                                c,
+              float const                                                 *k,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const      &b,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const final
+  {
+    FixedKernel<Scalar, ND, Func>::Gather(k, c, b, x, y);
+  }
 };
 
+template <typename Scalar, int ND, typename Func>
+auto MakeKernel(float const osamp, bool const tabulate) -> std::shared_ptr<KernelBase<Scalar, ND>>
+{
+  if (tabulate) {
+    return std::make_shared<Kernel<Scalar, ND, Tabulated<Func>>>(osamp);
+  } else {
+    return std::make_shared<Kernel<Scalar, ND, Func>>(osamp);
+  }
+}
+
 template <typename Scalar, int ND>
-auto KernelBase<Scalar, ND>::Make(std::string const &kType, float const osamp) -> std::shared_ptr<KernelBase<Scalar, ND>>
+auto KernelBase<Scalar, ND>::Make(std::string const &kType, float const osamp, bool const tabulate)
+  -> std::shared_ptr<KernelBase<Scalar, ND>>
 {
   if (kType == "NN") {
     return std::make_shared<NearestNeighbour<Scalar, ND>>();
@@ -92,18 +144,18 @@ auto KernelBase<Scalar, ND>::Make(std::string const &kType, float const osamp) -
     int const         W = std::stoi(kType.substr(2, 1));
     if (type == "ES") {
       switch (W) {
-      case 3: return std::make_shared<Kernel<Scalar, ND, ExpSemi<3>>>(osamp);
-      case 4: return std::make_shared<Kernel<Scalar, ND, ExpSemi<4>>>(osamp);
-      case 5: return std::make_shared<Kernel<Scalar, ND, ExpSemi<5>>>(osamp);
-      case 7: return std::make_shared<Kernel<Scalar, ND, ExpSemi<7>>>(osamp);
+      case 3: return MakeKernel<Scalar, ND, ExpSemi<3>>(osamp, tabulate);
+      case 4: return MakeKernel<Scalar, ND, ExpSemi<4>>(osamp, tabulate);
+      case 5: return MakeKernel<Scalar, ND, ExpSemi<5>>(osamp, tabulate);
+      case 7: return MakeKernel<Scalar, ND, ExpSemi<7>>(osamp, tabulate);
       default: Log::Fail("Unsupported kernel width {}", W);
       }
     } else if (type == "KB") {
       switch (W) {
-      case 3: return std::make_shared<Kernel<Scalar, ND, KaiserBessel<3>>>(osamp);
-      case 4: return std::make_shared<Kernel<Scalar, ND, KaiserBessel<4>>>(osamp);
-      case 5: return std::make_shared<Kernel<Scalar, ND, KaiserBessel<5>>>(osamp);
-      case 7: return std::make_shared<Kernel<Scalar, ND, KaiserBessel<7>>>(osamp);
+      case 3: return MakeKernel<Scalar, ND, KaiserBessel<3>>(osamp, tabulate);
+      case 4: return MakeKernel<Scalar, ND, KaiserBessel<4>>(osamp, tabulate);
+      case 5: return MakeKernel<Scalar, ND, KaiserBessel<5>>(osamp, tabulate);
+      case 7: return MakeKernel<Scalar, ND, KaiserBessel<7>>(osamp, tabulate);
       default: Log::Fail("Unsupported kernel width {}", W);
       }
     }
@@ -30,10 +30,10 @@ template <typename Scalar, int ND> struct NearestNeighbour final : KernelBase<Sc
     return z;
   }
 
-  void spread(std::array<int16_t, ND> const   c,
-              Point const                    &p,
-              Eigen::Tensor<Scalar, 1> const &y,
-              Eigen::Tensor<Scalar, ND + 2>  &x) const final
+  void spread(std::array<int16_t, ND> const                           c,
+              Point const                                            &p,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const final
   {
     Index const nC = x.dimension(1);
     for (Index ic = 0; ic < nC; ic++) {
@@ -48,18 +48,18 @@ template <typename Scalar, int ND> struct NearestNeighbour final : KernelBase<Sc
     }
   }
 
-  void spread(std::array<int16_t, ND> const   c,
-              Point const                    &p,
-              Eigen::Tensor<Scalar, 1> const &b,
-              Eigen::Tensor<Scalar, 1> const &y,
-              Eigen::Tensor<Scalar, ND + 2>  &x) const final
+  void spread(std::array<int16_t, ND> const                           c,
+              Point const                                            &p,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const final
   {
     Index const nC = x.dimension(1);
     Index const nB = b.size();
     for (Index ic = 0; ic < nC; ic++) {
       Scalar const yval = y(ic);
       for (Index ib = 0; ib < nB; ib++) {
-        Scalar const bval = b(ib) * yval;
+        Scalar const bval = Eigen::numext::conj(b(ib)) * yval;
         if constexpr (ND == 1) {
           x(ib, ic, c[0]) += bval;
         } else if constexpr (ND == 2) {
@@ -90,7 +90,7 @@ template <typename Scalar, int ND> struct NearestNeighbour final : KernelBase<Sc
 
   void gather(std::array<int16_t, ND> const                                c,
               Point const                                                 &p,
-              Eigen::Tensor<Scalar, 1> const                              &b,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const      &b,
               Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
               Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const final
   {
@@ -109,6 +109,42 @@ template <typename Scalar, int ND> struct NearestNeighbour final : KernelBase<Sc
       }
     }
   }
+
+  void weights(Point const &, float *k) const final { *k = 1.f; }
+
+  void spread(std::array<int16_t, ND> const                           c,
+              float const                                            *,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const final
+  {
+    spread(c, Point::Zero(), y, x);
+  }
+
+  void spread(std::array<int16_t, ND> const                           c,
+              float const                                            *,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const final
+  {
+    spread(c, Point::Zero(), b, y, x);
+  }
+
+  void gather(std::array<int16_t, ND> const                                c,
+              float const                                                 *,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const final
+  {
+    gather(c, Point::Zero(), x, y);
+  }
+
+  void gather(std::array<int16_t, ND> const                                c,
+              float const                                                 *,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const      &b,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
+              Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const final
+  {
+    gather(c, Point::Zero(), b, x, y);
+  }
 };
 
 } // namespace rl
@@ -10,26 +10,49 @@ template <typename Scalar, int ND> struct KernelBase
   using Point = Eigen::Matrix<float, ND, 1>;
   virtual auto paddedWidth() const -> int = 0;
   virtual auto operator()(Point const p) const -> Eigen::Tensor<float, ND> = 0;
-  virtual void spread(std::array<int16_t, ND> const   c,
-                      Point const                    &p,
-                      Eigen::Tensor<Scalar, 1> const &y,
-                      Eigen::Tensor<Scalar, ND + 2>  &x) const = 0;
-  virtual void spread(std::array<int16_t, ND> const   c,
-                      Point const                    &p,
-                      Eigen::Tensor<Scalar, 1> const &b,
-                      Eigen::Tensor<Scalar, 1> const &y,
-                      Eigen::Tensor<Scalar, ND + 2>  &x) const = 0;
+  /* Spread is the adjoint of gather, so the basis versions use the conjugate of b */
+  virtual void spread(std::array<int16_t, ND> const                           c,
+                      Point const                                            &p,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const = 0;
+  virtual void spread(std::array<int16_t, ND> const                           c,
+                      Point const                                            &p,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const = 0;
   virtual void gather(std::array<int16_t, ND> const                                c,
                       Point const                                                 &p,
                       Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const = 0;
   virtual void gather(std::array<int16_t, ND> const                                c,
                       Point const                                                 &p,
-                      Eigen::Tensor<Scalar, 1> const                              &b,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const      &b,
                       Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
                       Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const = 0;
 
-  static auto Make(std::string const &type, float const osamp) -> std::shared_ptr<KernelBase<Scalar, ND>>;
+  /* Precomputed weights, paddedWidth()^ND values per point */
+  virtual void weights(Point const &p, float *k) const = 0;
+  virtual void spread(std::array<int16_t, ND> const                           c,
+                      float const                                            *k,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const = 0;
+  virtual void spread(std::array<int16_t, ND> const                           c,
+                      float const                                            *k,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &b,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const &y,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2>>        &x) const = 0;
+  virtual void gather(std::array<int16_t, ND> const                                c,
+                      float const                                                 *k,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const = 0;
+  virtual void gather(std::array<int16_t, ND> const                                c,
+                      float const                                                 *k,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1> const> const      &b,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, ND + 2> const> const &x,
+                      Eigen::TensorMap<Eigen::Tensor<Scalar, 1>>                  &y) const = 0;
+
+  static auto Make(std::string const &type, float const osamp, bool const tabulate = false)
+    -> std::shared_ptr<KernelBase<Scalar, ND>>;
 };
 
 } // namespace rl
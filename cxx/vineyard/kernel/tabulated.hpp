@@ -0,0 +1,41 @@
+#pragma once
+
+#include "log.hpp"
+#include <vector>
+
+namespace rl {
+
+/*
+ *  Wraps a kernel function with a fine lookup-table over z² ∈ [0, 1] and linear interpolation, to avoid evaluating
+ *  exp/sqrt/Bessel functions for every tap.
+ */
+template <typename Func> struct Tabulated
+{
+  static constexpr int Width = Func::Width;
+  static constexpr int PadWidth = Func::PadWidth;
+  static constexpr int N = 4096;
+
+  std::vector<float> table;
+
+  Tabulated(float const osamp)
+    : table(N + 2)
+  {
+    Func const f(osamp);
+    for (Index ii = 0; ii <= N; ii++) {
+      table[ii] = f(ii / (float)N);
+    }
+    table[N + 1] = table[N];
+    Log::Print("Kernel lookup-table with {} entries", N);
+  }
+
+  inline auto operator()(float const z2) const -> float
+  {
+    if (z2 > 1.f) { return 0.f; }
+    float const x = z2 * N;
+    Index const i = static_cast<Index>(x);
+    float const t = x - i;
+    return table[i] + t * (table[i + 1] - table[i]);
+  }
+};
+
+} // namespace rl
@@ -72,6 +72,7 @@ auto TheTime() -> std::string
 
 void StartProgress(Index const amount, std::string const &text)
 {
+  std::scoped_lock lock(progressMutex); // Concurrent stages may report progress at the same time
   if (text.size() && CurrentLevel() >= Level::Standard) {
     progressMessage = text;
     fmt::print(stderr, "{} Starting {}\n", TheTime(), progressMessage);
@@ -85,8 +86,8 @@ void StartProgress(Index const amount, std::string const &text)
 
 void StopProgress()
 {
+  std::scoped_lock lock(progressMutex);
   if (isTTY && CurrentLevel() >= Level::Ephemeral) {
-    std::scoped_lock lock(progressMutex);
     progressTarget = -1;
     fmt::print(stderr, "\r");
   }
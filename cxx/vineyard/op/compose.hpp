@@ -2,6 +2,8 @@
 
 #include "top.hpp"
 
+#include "arena.hpp"
+
 #include <fmt/format.h>
 
 namespace rl::TOps {
@@ -35,9 +37,9 @@ template <typename Op1, typename Op2> struct Compose final : TOp<typename Op1::S
   {
     assert(x.dimensions() == op1_->ishape);
     assert(y.dimensions() == op2_->oshape);
-    typename Op1::OutTensor temp(op1_->oshape);
-    typename Op1::OutMap    tm(temp.data(), op1_->oshape);
-    typename Op1::OutCMap   tcm(temp.data(), op1_->oshape);
+    Arena::Lease            temp(Product(op1_->oshape) * sizeof(Scalar));
+    typename Op1::OutMap    tm(temp.data<Scalar>(), op1_->oshape);
+    typename Op1::OutCMap   tcm(temp.data<Scalar>(), op1_->oshape);
     auto const              time = this->startForward(x, y, false);
     op1_->forward(x, tm);
     op2_->forward(tcm, y);
@@ -48,9 +50,9 @@ template <typename Op1, typename Op2> struct Compose final : TOp<typename Op1::S
   {
     assert(x.dimensions() == op1_->ishape);
     assert(y.dimensions() == op2_->oshape);
-    typename Op1::OutTensor temp(op1_->oshape);
-    typename Op1::OutMap    tm(temp.data(), op1_->oshape);
-    typename Op1::OutCMap   tcm(temp.data(), op1_->oshape);
+    Arena::Lease            temp(Product(op1_->oshape) * sizeof(Scalar));
+    typename Op1::OutMap    tm(temp.data<Scalar>(), op1_->oshape);
+    typename Op1::OutCMap   tcm(temp.data<Scalar>(), op1_->oshape);
     auto const              time = this->startAdjoint(y, x, false);
     op2_->adjoint(y, tm);
     op1_->adjoint(tcm, x);
@@ -61,9 +63,9 @@ template <typename Op1, typename Op2> struct Compose final : TOp<typename Op1::S
   {
     assert(x.dimensions() == op1_->ishape);
     assert(y.dimensions() == op2_->oshape);
-    typename Op1::OutTensor temp(op1_->oshape);
-    typename Op1::OutMap    tm(temp.data(), op1_->oshape);
-    typename Op1::OutCMap   tcm(temp.data(), op1_->oshape);
+    Arena::Lease            temp(Product(op1_->oshape) * sizeof(Scalar));
+    typename Op1::OutMap    tm(temp.data<Scalar>(), op1_->oshape);
+    typename Op1::OutCMap   tcm(temp.data<Scalar>(), op1_->oshape);
     auto const              time = this->startForward(x, y, true);
     op1_->forward(x, tm);
     op2_->iforward(tcm, y);
@@ -74,9 +76,9 @@ template <typename Op1, typename Op2> struct Compose final : TOp<typename Op1::S
   {
     assert(x.dimensions() == op1_->ishape);
     assert(y.dimensions() == op2_->oshape);
-    typename Op1::OutTensor temp(op1_->oshape);
-    typename Op1::OutMap    tm(temp.data(), op1_->oshape);
-    typename Op1::OutCMap   tcm(temp.data(), op1_->oshape);
+    Arena::Lease            temp(Product(op1_->oshape) * sizeof(Scalar));
+    typename Op1::OutMap    tm(temp.data<Scalar>(), op1_->oshape);
+    typename Op1::OutCMap   tcm(temp.data<Scalar>(), op1_->oshape);
     auto const              time = this->startAdjoint(y, x, true);
     op2_->adjoint(y, tm);
     op1_->iadjoint(tcm, x);
@@ -94,4 +96,86 @@ auto MakeCompose(std::shared_ptr<Op1> op1, std::shared_ptr<Op2> op2) -> Compose<
   return std::make_shared<Compose<Op1, Op2>>(op1, op2);
 }
 
+/*
+ * This represents Op1' * Op2 * Op1, e.g. the SENSE expansion around a NUFFTNormal. Op2 must be square.
+ */
+template <typename Op1, typename Op2> struct Sandwich final : TOp<typename Op1::Scalar, Op1::InRank, Op1::InRank>
+{
+  TOP_INHERIT(typename Op1::Scalar, Op1::InRank, Op1::InRank)
+
+  Sandwich(std::shared_ptr<Op1> op1, std::shared_ptr<Op2> op2)
+    : Parent(fmt::format("{}'+{}+{}", op1->name, op2->name, op1->name), op1->ishape, op1->ishape)
+    , op1_{op1}
+    , op2_{op2}
+  {
+    if (op1_->oshape != op2_->ishape || op2_->ishape != op2_->oshape) {
+      throw(std::runtime_error(
+        fmt::format("{} op1 output: {} did not match op2 input: {} output: {}", this->name, op1_->oshape, op2_->ishape,
+                    op2_->oshape)));
+    }
+  }
+
+  using Parent::adjoint;
+  using Parent::forward;
+  using Ptr = std::shared_ptr<Sandwich>;
+
+  void forward(InCMap const &x, OutMap &y) const
+  {
+    Arena::Lease          temp1(Product(op1_->oshape) * sizeof(Scalar)), temp2(Product(op1_->oshape) * sizeof(Scalar));
+    typename Op1::OutMap  t1m(temp1.data<Scalar>(), op1_->oshape), t2m(temp2.data<Scalar>(), op1_->oshape);
+    typename Op1::OutCMap t1cm(temp1.data<Scalar>(), op1_->oshape), t2cm(temp2.data<Scalar>(), op1_->oshape);
+    auto const            time = this->startForward(x, y, false);
+    op1_->forward(x, t1m);
+    op2_->forward(t1cm, t2m);
+    op1_->adjoint(t2cm, y);
+    this->finishForward(y, time, false);
+  }
+
+  void adjoint(OutCMap const &y, InMap &x) const
+  {
+    Arena::Lease          temp1(Product(op1_->oshape) * sizeof(Scalar)), temp2(Product(op1_->oshape) * sizeof(Scalar));
+    typename Op1::OutMap  t1m(temp1.data<Scalar>(), op1_->oshape), t2m(temp2.data<Scalar>(), op1_->oshape);
+    typename Op1::OutCMap t1cm(temp1.data<Scalar>(), op1_->oshape), t2cm(temp2.data<Scalar>(), op1_->oshape);
+    auto const            time = this->startAdjoint(y, x, false);
+    op1_->forward(y, t1m);
+    op2_->adjoint(t1cm, t2m);
+    op1_->adjoint(t2cm, x);
+    this->finishAdjoint(x, time, false);
+  }
+
+  void iforward(InCMap const &x, OutMap &y) const
+  {
+    Arena::Lease          temp1(Product(op1_->oshape) * sizeof(Scalar)), temp2(Product(op1_->oshape) * sizeof(Scalar));
+    typename Op1::OutMap  t1m(temp1.data<Scalar>(), op1_->oshape), t2m(temp2.data<Scalar>(), op1_->oshape);
+    typename Op1::OutCMap t1cm(temp1.data<Scalar>(), op1_->oshape), t2cm(temp2.data<Scalar>(), op1_->oshape);
+    auto const            time = this->startForward(x, y, true);
+    op1_->forward(x, t1m);
+    op2_->forward(t1cm, t2m);
+    op1_->iadjoint(t2cm, y);
+    this->finishForward(y, time, true);
+  }
+
+  void iadjoint(OutCMap const &y, InMap &x) const
+  {
+    Arena::Lease          temp1(Product(op1_->oshape) * sizeof(Scalar)), temp2(Product(op1_->oshape) * sizeof(Scalar));
+    typename Op1::OutMap  t1m(temp1.data<Scalar>(), op1_->oshape), t2m(temp2.data<Scalar>(), op1_->oshape);
+    typename Op1::OutCMap t1cm(temp1.data<Scalar>(), op1_->oshape), t2cm(temp2.data<Scalar>(), op1_->oshape);
+    auto const            time = this->startAdjoint(y, x, true);
+    op1_->forward(y, t1m);
+    op2_->adjoint(t1cm, t2m);
+    op1_->iadjoint(t2cm, x);
+    this->finishAdjoint(x, time, true);
+  }
+
+private:
+  std::shared_ptr<Op1> op1_;
+  std::shared_ptr<Op2> op2_;
+};
+
+template <typename Op1, typename Op2>
+auto MakeSandwich(std::shared_ptr<Op1> op1, std::shared_ptr<Op2> op2) -> Sandwich<Op1, Op2>::Ptr
+{
+  return std::make_shared<Sandwich<Op1, Op2>>(op1, op2);
+}
+
 } // namespace rl::TOps
@@ -5,20 +5,29 @@
 
 namespace rl::TOps {
 
+namespace {
+template <int Rank, int FFTRank> auto TrailingDims() -> Sz<FFTRank>
+{
+  Sz<FFTRank> dims;
+  std::iota(dims.begin(), dims.end(), Rank - FFTRank);
+  return dims;
+}
+} // namespace
+
 template <int Rank, int FFTRank>
 FFT<Rank, FFTRank>::FFT(InDims const &dims, bool const adj)
   : Parent(fmt::format("FFT{}", adj ? " Inverse" : ""), dims, dims)
+  , plan_{dims, TrailingDims<Rank, FFTRank>()}
   , adjoint_{adj}
 {
-  std::iota(dims_.begin(), dims_.end(), Rank - FFTRank);
-  ph_ = rl::FFT::PhaseShift(LastN<FFTRank>(ishape));
 }
 
 template <int Rank, int FFTRank>
 FFT<Rank, FFTRank>::FFT(InMap x)
   : Parent("FFT", x.dimensions(), x.dimensions())
+  , plan_{x.dimensions(), TrailingDims<Rank, FFTRank>()}
+  , adjoint_{false}
 {
-  std::iota(dims_.begin(), dims_.end(), Rank - FFTRank);
 }
 
 template <int Rank, int FFTRank>
@@ -32,9 +41,9 @@ template <int Rank, int FFTRank> void FFT<Rank, FFTRank>::forward(InCMap const &
   auto const time = this->startForward(x, y, false);
   y = x;
   if (adjoint_) {
-    rl::FFT::Adjoint(y, dims_, ph_);
+    plan_.adjoint(y);
   } else {
-    rl::FFT::Forward(y, dims_, ph_);
+    plan_.forward(y);
   }
   this->finishForward(y, time, false);
 }
@@ -44,9 +53,9 @@ template <int Rank, int FFTRank> void FFT<Rank, FFTRank>::adjoint(OutCMap const
   auto const time = this->startAdjoint(y, x, false);
   x = y;
   if (adjoint_) {
-    rl::FFT::Forward(x, dims_, ph_);
+    plan_.forward(x);
   } else {
-    rl::FFT::Adjoint(x, dims_, ph_);
+    plan_.adjoint(x);
   }
   this->finishAdjoint(x, time, false);
 }
@@ -56,9 +65,9 @@ template <int Rank, int FFTRank> void FFT<Rank, FFTRank>::iforward(InCMap const
   auto const time = this->startForward(x, y, true);
   InTensor   tmp = x;
   if (adjoint_) {
-    rl::FFT::Adjoint(tmp, dims_, ph_);
+    plan_.adjoint(tmp);
   } else {
-    rl::FFT::Forward(tmp, dims_, ph_);
+    plan_.forward(tmp);
   }
   y += tmp;
   this->finishForward(y, time, true);
@@ -69,9 +78,9 @@ template <int Rank, int FFTRank> void FFT<Rank, FFTRank>::iadjoint(OutCMap const
   auto const time = this->startAdjoint(y, x, true);
   InTensor   tmp = y;
   if (adjoint_) {
-    rl::FFT::Forward(tmp, dims_, ph_);
+    plan_.forward(tmp);
   } else {
-    rl::FFT::Adjoint(tmp, dims_, ph_);
+    plan_.adjoint(tmp);
   }
   x += tmp;
   this->finishAdjoint(x, time, true);
@@ -25,9 +25,8 @@ template <int Rank, int FFTRank> struct FFT final : TOp<Cx, Rank, Rank>
   void iadjoint(OutCMap const &y, InMap &x) const;
 
 private:
-  Sz<FFTRank>  dims_;
-  CxN<FFTRank> ph_;
-  bool adjoint_;
+  rl::FFT::Plan<Rank, FFTRank> plan_;
+  bool                         adjoint_;
 };
 
 } // namespace rl::TOps
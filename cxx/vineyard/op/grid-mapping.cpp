@@ -7,7 +7,9 @@
 #include <tl/chunk.hpp>
 #include <tl/to.hpp>
 
+#include "cache.hpp"
 #include "tensors.hpp"
+#include "threads.hpp"
 
 namespace rl {
 
@@ -17,6 +19,13 @@ template <typename T> inline decltype(auto) nearby(T &&x)
   return x.array().unaryExpr([](float const &e) { return (Index)std::nearbyint(e); });
 }
 
+/*
+ * Mappings are built in two parallel passes over fixed blocks of traces. The first counts how many samples from each
+ * block land in each subgrid, a prefix sum over (subgrid, block) then gives every block its own output slots in a
+ * pre-sized vector, and the second pass scatters the mappings into them. This is a counting sort on the subgrid that
+ * keeps trace/sample order within a subgrid, so a stable sort on the cartesian location within each subgrid completes
+ * the ordering deterministically.
+ */
 template <int ND>
 auto CalcMapping(TrajectoryN<ND> const &traj, float const nomOS, Index const kW, Index const sgSz) -> CalcMapping_t<ND>
 {
@@ -27,58 +36,227 @@ auto CalcMapping(TrajectoryN<ND> const &traj, float const nomOS, Index const kW,
   Log::Print("Mapping samples {} traces {} OS {} Matrix {} Grid {}", traj.nSamples(), traj.nTraces(), nomOS, nomDims, cartDims);
 
   std::fesetround(FE_TONEAREST);
-  auto const               center = Div(cartDims, 2);
-  Index                  valid = 0;
-  Index                    invalids = 0;
-  std::vector<Mapping<ND>> mappings;
-  for (int32_t it = 0; it < traj.nTraces(); it++) {
-    for (int16_t is = 0; is < traj.nSamples(); is++) {
-      Re1 const p = traj.point(is, it);
-      if (!B0(p.isfinite().all())()) {
-        invalids++;
-        continue;
-      }
-      Eigen::Array<float, ND, 1> xyz;
-      for (Index ii = 0; ii < ND; ii++) {
-        xyz[ii] = p[ii] * osamp + center[(size_t)ii];
+  auto const  center = Div(cartDims, 2);
+  Re3 const  &points = traj.points();
+  Index const nS = traj.nSamples();
+  Index const nT = traj.nTraces();
+  Sz<ND>      nSg;
+  for (Index id = 0; id < ND; id++) {
+    nSg[id] = (cartDims[id] + sgSz - 1) / sgSz;
+  }
+  Index const nBins = Product(nSg);
+
+  // Returns the subgrid bin, or -1 for an invalid point
+  auto calc = [&](int16_t const is, int32_t const it, Mapping<ND> &m) -> Index {
+    Eigen::Array<float, ND, 1> xyz;
+    for (Index ii = 0; ii < ND; ii++) {
+      float const p = points(ii, is, it);
+      if (!std::isfinite(p)) { return -1; }
+      xyz[ii] = p * osamp + center[(size_t)ii];
+    }
+    auto const gp = nearby(xyz);
+    m.offset = xyz - gp.template cast<float>();
+    m.sample = is;
+    m.trace = it;
+    Index bin = 0;
+    for (Index id = ND - 1; id >= 0; id--) {
+      Index const ijk = Wrap(gp[id], cartDims[(size_t)id]);
+      Index const isg = ijk / sgSz;
+      m.cart[id] = static_cast<int16_t>(ijk - (sgSz * isg - (kW / 2)));
+      bin = bin * nSg[id] + isg;
+    }
+    return bin;
+  };
+
+  Index const        nBlk = std::clamp<Index>(Threads::GlobalThreadCount(), 1, std::max<Index>(nT, 1));
+  std::vector<Index> counts(nBins * nBlk, 0);
+  Threads::For(
+    [&](Index const ib) {
+      Index      *c = counts.data() + ib * nBins;
+      Mapping<ND> m;
+      for (int32_t it = ib * nT / nBlk; it < (ib + 1) * nT / nBlk; it++) {
+        for (int16_t is = 0; is < nS; is++) {
+          Index const bin = calc(is, it, m);
+          if (bin >= 0) { c[bin]++; }
+        }
       }
-      auto const                       gp = nearby(xyz);
-      Eigen::Array<float, ND, 1> const off = xyz - gp.template cast<float>();
+    },
+    nBlk);
 
-      std::array<int16_t, ND> ijk;
-      for (int ii = 0; ii < ND; ii++) {
-        ijk[(size_t)ii] = static_cast<int16_t>(Wrap(gp[ii], cartDims[(size_t)ii]));
+  // Exclusive prefix sum in (bin, block) order, so blocks are consecutive within each bin
+  std::vector<Index> binStart(nBins + 1);
+  Index              valid = 0;
+  for (Index ibin = 0; ibin < nBins; ibin++) {
+    binStart[ibin] = valid;
+    for (Index ib = 0; ib < nBlk; ib++) {
+      Index const n = counts[ib * nBins + ibin];
+      counts[ib * nBins + ibin] = valid;
+      valid += n;
+    }
+  }
+  binStart[nBins] = valid;
+  Log::Print("Ignored {} invalid trajectory points, {} remaing", nS * nT - valid, valid);
+
+  std::vector<Mapping<ND>> mappings(valid);
+  Threads::For(
+    [&](Index const ib) {
+      Index      *next = counts.data() + ib * nBins;
+      Mapping<ND> m;
+      for (int32_t it = ib * nT / nBlk; it < (ib + 1) * nT / nBlk; it++) {
+        for (int16_t is = 0; is < nS; is++) {
+          Index const bin = calc(is, it, m);
+          if (bin >= 0) { mappings[next[bin]++] = m; }
+        }
       }
+    },
+    nBlk);
 
-      Sz<ND> subgrid;
-      for (Index id = 0; id < ND; id++) {
-        auto const m = sgSz * (ijk[id] / sgSz);
-        subgrid[id] = m - (kW / 2);
-        ijk[id] -= subgrid[id];
+  Threads::ParallelFor(0, nBins, 0, [&](Index const lo, Index const hi) {
+    for (Index ibin = lo; ibin < hi; ibin++) {
+      std::stable_sort(mappings.begin() + binStart[ibin], mappings.begin() + binStart[ibin + 1],
+                       [](Mapping<ND> const &a, Mapping<ND> const &b) {
+                         for (size_t di = 0; di < ND; di++) {
+                           size_t id = ND - 1 - di;
+                           if (a.cart[id] != b.cart[id]) { return a.cart[id] < b.cart[id]; }
+                         }
+                         return false;
+                       });
+    }
+  });
+
+  // Each non-empty bin becomes one run, bins are numbered with the first dimension fastest
+  std::vector<SubgridRun<ND>> subgrids;
+  for (Index ibin = 0; ibin < nBins; ibin++) {
+    if (binStart[ibin + 1] == binStart[ibin]) { continue; }
+    SubgridRun<ND> run{.subgrid = {}, .start = binStart[ibin], .size = binStart[ibin + 1] - binStart[ibin]};
+    Index          b = ibin;
+    for (Index id = 0; id < ND; id++) {
+      run.subgrid[id] = sgSz * (b % nSg[id]) - (kW / 2);
+      b /= nSg[id];
+    }
+    subgrids.push_back(run);
+  }
+  Log::Debug("Mappings {} in {} subgrids, {} bytes each", valid, subgrids.size(), sizeof(Mapping<ND>));
+  return {std::move(mappings), std::move(subgrids), noncartDims, cartDims};
+}
+
+/*
+ * Cache entries hold the integer fields as one (ND + 2) x N dataset (cart, sample, trace), the offsets as a float
+ * dataset, and the runs as another integer dataset (subgrid, start, size). Bump the version if the layout changes.
+ */
+template <int ND>
+auto CachedMapping(TrajectoryN<ND> const &traj, float const nomOS, Index const kW, Index const sgSz) -> CalcMapping_t<ND>
+{
+  Index constexpr version = 1;
+  Cache::Key key;
+  key.add(version).add(ND).add(traj.points().data(), traj.points().size()).add(traj.matrix()).add(nomOS).add(kW).add(sgSz);
+  if (auto const path = Cache::Lookup("mapping", key)) {
+    try {
+      HD5::Reader const reader(path.value());
+      I2 const          ints = reader.readTensor<I2>("mappings");
+      Re2 const         offsets = reader.readTensor<Re2>("offsets");
+      I2 const          runs = reader.readTensor<I2>("subgrids");
+      if (ints.dimension(0) != ND + 2 || offsets.dimension(0) != ND || offsets.dimension(1) != ints.dimension(1) ||
+          runs.dimension(0) != ND + 2) {
+        Log::Fail("Cached mappings had wrong dimensions");
+      }
+      CalcMapping_t<ND> m{.mappings = std::vector<Mapping<ND>>(ints.dimension(1)),
+                          .subgrids = std::vector<SubgridRun<ND>>(runs.dimension(1)),
+                          .noncartDims = reader.readAttributeSz<2>("subgrids", "noncartDims"),
+                          .cartDims = reader.readAttributeSz<ND>("subgrids", "cartDims")};
+      for (size_t im = 0; im < m.mappings.size(); im++) {
+        auto &mp = m.mappings[im];
+        for (Index id = 0; id < ND; id++) {
+          mp.cart[id] = static_cast<int16_t>(ints(id, im));
+          mp.offset[id] = offsets(id, im);
+        }
+        mp.sample = static_cast<int16_t>(ints(ND, im));
+        mp.trace = static_cast<int32_t>(ints(ND + 1, im));
       }
-      mappings.push_back(Mapping<ND>{.cart = ijk, .sample = is, .trace = it, .offset = off, .subgrid = subgrid});
-      valid++;
+      for (size_t ir = 0; ir < m.subgrids.size(); ir++) {
+        auto &run = m.subgrids[ir];
+        for (Index id = 0; id < ND; id++) {
+          run.subgrid[id] = runs(id, ir);
+        }
+        run.start = runs(ND, ir);
+        run.size = runs(ND + 1, ir);
+      }
+      return m;
+    } catch (Log::Failure const &) {
+      Log::Warn("Could not read cached mappings, recalculating");
     }
   }
-  Log::Print("Ignored {} invalid trajectory points, {} remaing", invalids, valid);
-
-  std::sort(mappings.begin(), mappings.end(), [](Mapping<ND> const &a, Mapping<ND> const &b) {
-    // First compare on subgrids
-    for (size_t di = 0; di < ND; di++) {
-      size_t id = ND - 1 - di;
-      if (a.subgrid[id] < b.subgrid[id]) { return true; }
-      else if (b.subgrid[id] < a.subgrid[id]) {return false; }
+
+  auto m = CalcMapping(traj, nomOS, kW, sgSz);
+  if (m.mappings.empty()) { return m; }
+  Cache::Store("mapping", key, [&m](HD5::Writer &writer) {
+    Index const nM = m.mappings.size();
+    Index const nR = m.subgrids.size();
+    I2          ints(ND + 2, nM);
+    Re2         offsets(ND, nM);
+    I2          runs(ND + 2, nR);
+    for (Index im = 0; im < nM; im++) {
+      auto const &mp = m.mappings[im];
+      for (Index id = 0; id < ND; id++) {
+        ints(id, im) = mp.cart[id];
+        offsets(id, im) = mp.offset[id];
+      }
+      ints(ND, im) = mp.sample;
+      ints(ND + 1, im) = mp.trace;
     }
-    // Then compare on ijk location
-    for (size_t di = 0; di < ND; di++) {
-      size_t id = ND - 1 - di;
-      if (a.cart[id] < b.cart[id]) { return true; }
-      else if (b.cart[id] < a.cart[id]) {return false; }
+    for (Index ir = 0; ir < nR; ir++) {
+      auto const &run = m.subgrids[ir];
+      for (Index id = 0; id < ND; id++) {
+        runs(id, ir) = run.subgrid[id];
+      }
+      runs(ND, ir) = run.start;
+      runs(ND + 1, ir) = run.size;
     }
-    return false;
+    writer.writeTensor("mappings", ints.dimensions(), ints.data(), HD5::DimensionNames<2>{"v", "mapping"});
+    writer.writeTensor("offsets", offsets.dimensions(), offsets.data(), HD5::DimensionNames<2>{"v", "mapping"});
+    writer.writeTensor("subgrids", runs.dimensions(), runs.data(), HD5::DimensionNames<2>{"v", "subgrid"});
+    writer.writeAttribute("subgrids", "noncartDims", m.noncartDims);
+    writer.writeAttribute("subgrids", "cartDims", m.cartDims);
   });
+  return m;
+}
 
-  return {mappings, noncartDims, cartDims};
+template <int ND>
+auto ColourSubgrids(std::vector<SubgridRun<ND>> const &subgrids, Sz<ND> const cartDims, Index const kW, Index const sgSz)
+  -> std::vector<std::vector<SubgridRun<ND>>>
+{
+  // Subgrids span sgSz + 2 * hW points, so the same colour can only repeat every `stride` subgrids. If the number of
+  // subgrids along a dimension is not a multiple of the stride, the last few can touch the first ones across the
+  // periodic boundary. In that case give them a unique colour along that dimension.
+  Index const hW = kW / 2;
+  Index const stride = 1 + (2 * hW + sgSz - 1) / sgSz;
+  Sz<ND>      shared, nColours;
+  for (Index id = 0; id < ND; id++) {
+    Index const nSg = (cartDims[id] + sgSz - 1) / sgSz;
+    Index const lastRepeat = stride * ((nSg - 1) / stride);
+    if (cartDims[id] - lastRepeat * sgSz >= sgSz + 2 * hW) {
+      shared[id] = nSg;
+      nColours[id] = std::min(stride, nSg);
+    } else {
+      shared[id] = lastRepeat;
+      nColours[id] = stride + (nSg - lastRepeat);
+    }
+  }
+
+  std::vector<std::vector<SubgridRun<ND>>> colours(Product(nColours));
+  for (auto const &run : subgrids) {
+    Index colour = 0, stride_c = 1;
+    for (Index id = 0; id < ND; id++) {
+      Index const isg = (run.subgrid[id] + hW) / sgSz;
+      Index const c = isg < shared[id] ? isg % stride : stride + isg - shared[id];
+      colour += c * stride_c;
+      stride_c *= nColours[id];
+    }
+    colours[colour].push_back(run);
+  }
+  std::erase_if(colours, [](std::vector<SubgridRun<ND>> const &c) { return c.empty(); });
+  Log::Debug("Subgrid colours {} per dimension {}", colours.size(), nColours);
+  return colours;
 }
 
 template struct Mapping<1>;
@@ -92,4 +270,18 @@ template auto CalcMapping<2>(TrajectoryN<2> const &traj, float const nomOS, Inde
 template auto CalcMapping<3>(TrajectoryN<3> const &traj, float const nomOS, Index const kW, Index const sgSz)
   -> CalcMapping_t<3>;
 
+template auto CachedMapping<1>(TrajectoryN<1> const &traj, float const nomOS, Index const kW, Index const sgSz)
+  -> CalcMapping_t<1>;
+template auto CachedMapping<2>(TrajectoryN<2> const &traj, float const nomOS, Index const kW, Index const sgSz)
+  -> CalcMapping_t<2>;
+template auto CachedMapping<3>(TrajectoryN<3> const &traj, float const nomOS, Index const kW, Index const sgSz)
+  -> CalcMapping_t<3>;
+
+template auto ColourSubgrids<1>(std::vector<SubgridRun<1>> const &, Sz1 const, Index const, Index const)
+  -> std::vector<std::vector<SubgridRun<1>>>;
+template auto ColourSubgrids<2>(std::vector<SubgridRun<2>> const &, Sz2 const, Index const, Index const)
+  -> std::vector<std::vector<SubgridRun<2>>>;
+template auto ColourSubgrids<3>(std::vector<SubgridRun<3>> const &, Sz3 const, Index const, Index const)
+  -> std::vector<std::vector<SubgridRun<3>>>;
+
 } // namespace rl
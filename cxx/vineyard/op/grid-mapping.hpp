@@ -6,23 +6,50 @@
 
 namespace rl {
 
+/*
+ * A single non-cartesian sample. The cartesian location is relative to the corner of its subgrid, which is stored once
+ * per SubgridRun instead of in every mapping. Fields are ordered largest first so there is no padding.
+ */
 template <int ND> struct Mapping
 {
-  std::array<int16_t, ND>    cart;
-  int16_t                    sample;
-  int32_t                    trace;
   Eigen::Array<float, ND, 1> offset;
-  Sz<ND>                     subgrid;
+  int32_t                    trace;
+  int16_t                    sample;
+  std::array<int16_t, ND>    cart;
+};
+
+/*
+ * A contiguous run of (sorted) mappings that all fall in the same subgrid
+ */
+template <int ND> struct SubgridRun
+{
+  Sz<ND> subgrid;
+  Index  start, size;
 };
 
 template <int ND> struct CalcMapping_t
 {
-  std::vector<Mapping<ND>> mappings;
-  Sz2                      noncartDims;
-  Sz<ND>                   cartDims;
+  std::vector<Mapping<ND>>    mappings;
+  std::vector<SubgridRun<ND>> subgrids;
+  Sz2                         noncartDims;
+  Sz<ND>                      cartDims;
 };
 
 template <int ND>
 auto CalcMapping(TrajectoryN<ND> const &t, float const nomOSamp, Index const kW, Index const subgridSize) -> CalcMapping_t<ND>;
 
+/*
+ * As CalcMapping, but reuses the result from a previous run with the same trajectory and parameters if the cache is on
+ */
+template <int ND>
+auto CachedMapping(TrajectoryN<ND> const &t, float const nomOSamp, Index const kW, Index const subgridSize) -> CalcMapping_t<ND>;
+
+/*
+ * Partition the subgrid runs into colours such that no two subgrids of the same colour overlap, including their kernel
+ * halos and across the periodic grid boundary. All subgrids within a colour can then be written back without locking.
+ */
+template <int ND>
+auto ColourSubgrids(std::vector<SubgridRun<ND>> const &subgrids, Sz<ND> const cartDims, Index const kW, Index const subgridSize)
+  -> std::vector<std::vector<SubgridRun<ND>>>;
+
 } // namespace rl
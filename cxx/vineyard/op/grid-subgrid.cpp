@@ -11,7 +11,7 @@ namespace rl {
 /*****************************************************************************************************
  * No VCC at all
  ****************************************************************************************************/
-template <> void GridToSubgrid<1, false, false>(Sz1 const sg, Cx3CMap const &x, Cx3 &sx)
+template <> void GridToSubgrid<1, false, false>(Sz1 const sg, Cx3CMap const &x, Cx3Map &sx)
 {
   for (Index ix = 0; ix < sx.dimension(2); ix++) {
     Index const iix = Wrap(ix + sg[0], x.dimension(2));
@@ -23,7 +23,7 @@ template <> void GridToSubgrid<1, false, false>(Sz1 const sg, Cx3CMap const &x,
   }
 }
 
-template <> void GridToSubgrid<2, false, false>(Sz2 const sg, Cx4CMap const &x, Cx4 &sx)
+template <> void GridToSubgrid<2, false, false>(Sz2 const sg, Cx4CMap const &x, Cx4Map &sx)
 {
   for (Index iy = 0; iy < sx.dimension(3); iy++) {
     Index const iiy = Wrap(iy + sg[1], x.dimension(3));
@@ -38,7 +38,7 @@ template <> void GridToSubgrid<2, false, false>(Sz2 const sg, Cx4CMap const &x,
   }
 }
 
-template <> void GridToSubgrid<3, false, false>(Sz3 const sg, Cx5CMap const &x, Cx5 &sx)
+template <> void GridToSubgrid<3, false, false>(Sz3 const sg, Cx5CMap const &x, Cx5Map &sx)
 {
   for (Index iz = 0; iz < sx.dimension(4); iz++) {
     Index const iiz = Wrap(iz + sg[2], x.dimension(4));
@@ -104,7 +104,7 @@ template <> void SubgridToGrid<3, false, false>(Sz3 const sg, Cx5CMap const &sx,
 /*****************************************************************************************************
  * Has VCC but is not VCC
  ****************************************************************************************************/
-template <> void GridToSubgrid<1, true, false>(Sz1 const sg, Cx4CMap const &x, Cx3 &sx)
+template <> void GridToSubgrid<1, true, false>(Sz1 const sg, Cx4CMap const &x, Cx3Map &sx)
 {
   for (Index ix = 0; ix < sx.dimension(2); ix++) {
     Index const iix = Wrap(ix + sg[0], x.dimension(3));
@@ -116,7 +116,7 @@ template <> void GridToSubgrid<1, true, false>(Sz1 const sg, Cx4CMap const &x, C
   }
 }
 
-template <> void GridToSubgrid<2, true, false>(Sz2 const sg, Cx5CMap const &x, Cx4 &sx)
+template <> void GridToSubgrid<2, true, false>(Sz2 const sg, Cx5CMap const &x, Cx4Map &sx)
 {
   for (Index iy = 0; iy < sx.dimension(3); iy++) {
     Index const iiy = Wrap(iy + sg[1], x.dimension(4));
@@ -131,7 +131,7 @@ template <> void GridToSubgrid<2, true, false>(Sz2 const sg, Cx5CMap const &x, C
   }
 }
 
-template <> void GridToSubgrid<3, true, false>(Sz3 const sg, Cx6CMap const &x, Cx5 &sx)
+template <> void GridToSubgrid<3, true, false>(Sz3 const sg, Cx6CMap const &x, Cx5Map &sx)
 {
   for (Index iz = 0; iz < sx.dimension(4); iz++) {
     Index const iiz = Wrap(iz + sg[2], x.dimension(5));
@@ -196,7 +196,7 @@ template <> void SubgridToGrid<3, true, false>(Sz3 const sg, Cx5CMap const &sx,
 /*****************************************************************************************************
  * Has VCC and is VCC
  ****************************************************************************************************/
-template <> void GridToSubgrid<1, true, true>(Sz1 const sg, Cx4CMap const &x, Cx3 &sx)
+template <> void GridToSubgrid<1, true, true>(Sz1 const sg, Cx4CMap const &x, Cx3Map &sx)
 {
   for (Index ix = 0; ix < sx.dimension(2); ix++) {
     Index const iix = Wrap(ix + sg[0], x.dimension(3));
@@ -208,7 +208,7 @@ template <> void GridToSubgrid<1, true, true>(Sz1 const sg, Cx4CMap const &x, Cx
   }
 }
 
-template <> void GridToSubgrid<2, true, true>(Sz2 const sg, Cx5CMap const &x, Cx4 &sx)
+template <> void GridToSubgrid<2, true, true>(Sz2 const sg, Cx5CMap const &x, Cx4Map &sx)
 {
   for (Index iy = 0; iy < sx.dimension(3); iy++) {
     Index const iiy = Wrap(iy + sg[1], x.dimension(4));
@@ -223,7 +223,7 @@ template <> void GridToSubgrid<2, true, true>(Sz2 const sg, Cx5CMap const &x, Cx
   }
 }
 
-template <> void GridToSubgrid<3, true, true>(Sz3 const sg, Cx6CMap const &x, Cx5 &sx)
+template <> void GridToSubgrid<3, true, true>(Sz3 const sg, Cx6CMap const &x, Cx5Map &sx)
 {
   for (Index iz = 0; iz < sx.dimension(4); iz++) {
     Index const iiz = Wrap(iz + sg[2], x.dimension(5));
@@ -286,25 +286,25 @@ template <> void SubgridToGrid<3, true, true>(Sz3 const sg, Cx5CMap const &sx, C
   }
 }
 
-template <> void GridToSubgrid<1, false, false>(Sz1 const, Cx3CMap const &, Cx3 &);
-template <> void GridToSubgrid<2, false, false>(Sz2 const, Cx4CMap const &, Cx4 &);
-template <> void GridToSubgrid<3, false, false>(Sz3 const, Cx5CMap const &, Cx5 &);
+template <> void GridToSubgrid<1, false, false>(Sz1 const, Cx3CMap const &, Cx3Map &);
+template <> void GridToSubgrid<2, false, false>(Sz2 const, Cx4CMap const &, Cx4Map &);
+template <> void GridToSubgrid<3, false, false>(Sz3 const, Cx5CMap const &, Cx5Map &);
 
 template <> void SubgridToGrid<1, false, false>(Sz1 const, Cx3CMap const &, Cx3Map &);
 template <> void SubgridToGrid<2, false, false>(Sz2 const, Cx4CMap const &, Cx4Map &);
 template <> void SubgridToGrid<3, false, false>(Sz3 const, Cx5CMap const &, Cx5Map &);
 
-template <> void GridToSubgrid<1, true, false>(Sz1 const, Cx4CMap const &, Cx3 &);
-template <> void GridToSubgrid<2, true, false>(Sz2 const, Cx5CMap const &, Cx4 &);
-template <> void GridToSubgrid<3, true, false>(Sz3 const, Cx6CMap const &, Cx5 &);
+template <> void GridToSubgrid<1, true, false>(Sz1 const, Cx4CMap const &, Cx3Map &);
+template <> void GridToSubgrid<2, true, false>(Sz2 const, Cx5CMap const &, Cx4Map &);
+template <> void GridToSubgrid<3, true, false>(Sz3 const, Cx6CMap const &, Cx5Map &);
 
 template <> void SubgridToGrid<1, true, false>(Sz1 const, Cx3CMap const &, Cx4Map &);
 template <> void SubgridToGrid<2, true, false>(Sz2 const, Cx4CMap const &, Cx5Map &);
 template <> void SubgridToGrid<3, true, false>(Sz3 const, Cx5CMap const &, Cx6Map &);
 
-template <> void GridToSubgrid<1, true, true>(Sz1 const, Cx4CMap const &, Cx3 &);
-template <> void GridToSubgrid<2, true, true>(Sz2 const, Cx5CMap const &, Cx4 &);
-template <> void GridToSubgrid<3, true, true>(Sz3 const, Cx6CMap const &, Cx5 &);
+template <> void GridToSubgrid<1, true, true>(Sz1 const, Cx4CMap const &, Cx3Map &);
+template <> void GridToSubgrid<2, true, true>(Sz2 const, Cx5CMap const &, Cx4Map &);
+template <> void GridToSubgrid<3, true, true>(Sz3 const, Cx6CMap const &, Cx5Map &);
 
 template <> void SubgridToGrid<1, true, true>(Sz1 const, Cx3CMap const &, Cx4Map &);
 template <> void SubgridToGrid<2, true, true>(Sz2 const, Cx4CMap const &, Cx5Map &);
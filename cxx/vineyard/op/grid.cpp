@@ -1,13 +1,19 @@
 #include "grid.hpp"
 
+#include "arena.hpp"
+#include "cache.hpp"
+#include "io/reader.hpp"
+#include "io/writer.hpp"
+#include "log.hpp"
 #include "threads.hpp"
 #include "top.hpp"
 
-#include "chunkfor.hpp"
 #include "grid-subgrid.hpp"
 
+#include <limits>
 #include <mutex>
 #include <numbers>
+#include <span>
 
 namespace rl {
 
@@ -16,18 +22,24 @@ GridOpts::GridOpts(args::Subparser &parser)
   , osamp(parser, "O", "Grid oversampling factor (2)", {"osamp"}, 2.f)
   , vcc(parser, "V", "Virtual Conjugate Coils", {"vcc"})
   , batches(parser, "B", "Channel batch size (1)", {"batches"}, 1)
-  , subgridSize(parser, "B", "Gridding subgrid size (32)", {"subgrid-size"}, 32)
+  , subgridSize(parser, "B", "Gridding subgrid size, 0 to autotune (32)", {"subgrid-size"}, 32)
+  , kTable(parser, "M", "Precompute kernel weights within budget (MB), else use a lookup-table (0 = off)", {"kernel-table"}, 0)
+  , precision(parser, "P", "Storage precision for SENSE maps - float/half/bf16 (float)", {"precision"}, "float")
 {
 }
 
 namespace TOps {
 
 template <int NDim, bool VCC>
-auto Grid<NDim, VCC>::Make(
-  TrajectoryN<NDim> const &traj, std::string const ktype, float const osamp, Index const nC, Basis::CPtr b, Index const sgW)
-  -> std::shared_ptr<Grid<NDim, VCC>>
+auto Grid<NDim, VCC>::Make(TrajectoryN<NDim> const &traj,
+                           std::string const        ktype,
+                           float const              osamp,
+                           Index const              nC,
+                           Basis::CPtr              b,
+                           Index const              sgW,
+                           Index const              tableMB) -> std::shared_ptr<Grid<NDim, VCC>>
 {
-  return std::make_shared<Grid<NDim, VCC>>(traj, ktype, osamp, nC, b, sgW);
+  return std::make_shared<Grid<NDim, VCC>>(traj, ktype, osamp, nC, b, sgW, tableMB);
 }
 
 template <bool VCC, int ND> auto AddVCC(Sz<ND> const cart, Index const nC, Index const nB) -> Sz<ND + 2 + VCC>
@@ -39,65 +51,377 @@ template <bool VCC, int ND> auto AddVCC(Sz<ND> const cart, Index const nC, Index
   }
 }
 
+/* Size of the precomputed kernel weights for nM mappings */
+template <int ND> auto WeightsMB(Index const nM, Index const kW) -> Index
+{
+  return nM * std::pow(kW, ND) * sizeof(float) / (1024 * 1024);
+}
+
+template <int ND> auto KernelWeights(KernelBase<Cx, ND> const &kernel, std::vector<Mapping<ND>> const &mappings)
+  -> std::vector<float>
+{
+  Index const        kSz = std::pow(kernel.paddedWidth(), ND);
+  Index const        nM = mappings.size();
+  Index const        nT = Threads::GlobalThreadCount();
+  std::vector<float> w(nM * kSz);
+  Threads::For(
+    [&](Index const it) {
+      for (Index im = it * nM / nT; im < (it + 1) * nM / nT; im++) {
+        kernel.weights(mappings[im].offset.matrix(), w.data() + im * kSz);
+      }
+    },
+    nT);
+  return w;
+}
+
+/* Mappings that share a basis entry have the same key */
+template <int ND> inline auto EntryKey(Mapping<ND> const &m, Basis const &basis) -> Index
+{
+  return (m.trace % basis.nTrace()) * basis.nSample() + m.sample % basis.nSample();
+}
+
+/* Order the mappings within each subgrid run by basis entry, so that samples sharing an entry are adjacent */
+template <int ND>
+void SortByEntry(std::vector<Mapping<ND>> &mappings, std::vector<SubgridRun<ND>> const &runs, Basis const &basis)
+{
+  Threads::ParallelFor(0, runs.size(), 0, [&](Index const lo, Index const hi) {
+    for (Index ir = lo; ir < hi; ir++) {
+      auto const begin = mappings.begin() + runs[ir].start;
+      std::stable_sort(begin, begin + runs[ir].size, [&basis](Mapping<ND> const &a, Mapping<ND> const &b) {
+        return EntryKey(a, basis) < EntryKey(b, basis);
+      });
+    }
+  });
+}
+
+/*
+ * Scratch subgrids for one application, one per worker, carved from an arena lease so that the parallel loops do not
+ * allocate. If fusing with a non-trivial basis each worker also gets a basis-free subgrid for grouped contraction.
+ */
+template <int ND> struct Scratch
+{
+  static auto Bytes(Index const subgridW, bool const fused, Basis::CPtr const &basis, Index const nC) -> Index
+  {
+    Index const nB = basis ? basis->nB() : 1;
+    Index const sz = nC * std::pow(subgridW, ND);
+    return Threads::GlobalThreadCount() * sz * (nB + (Fusing(fused, basis) ? 1 : 0)) * sizeof(Cx);
+  }
+
+  Scratch(Index const subgridW, bool const fused, Basis::CPtr const &basis, Index const nC)
+    : lease{Bytes(subgridW, fused, basis, nC)}
+  {
+    Index const nT = Threads::GlobalThreadCount();
+    auto const  shape = AddFront(Constant<ND>(subgridW), basis ? basis->nB() : 1, nC);
+    auto const  shape1 = AddFront(Constant<ND>(subgridW), 1, nC);
+    Cx         *ptr = lease.data<Cx>();
+    for (Index it = 0; it < nT; it++, ptr += Product(shape)) {
+      sx.emplace_back(ptr, shape);
+    }
+    if (!Fusing(fused, basis)) { return; }
+    for (Index it = 0; it < nT; it++, ptr += Product(shape1)) {
+      s1.emplace_back(ptr, shape1);
+      s1.back().setZero();
+    }
+  }
+
+  /* The worker's basis scratch subgrid, if there is one */
+  auto worker1(Index const iw) -> CxNMap<ND + 2> * { return s1.empty() ? nullptr : &s1[iw]; }
+
+  Arena::Lease                lease;
+  std::vector<CxNMap<ND + 2>> sx, s1;
+
+private:
+  static auto Fusing(bool const fused, Basis::CPtr const &basis) -> bool { return fused && basis && basis->nB() > 1; }
+};
+
 template <int NDim, bool VCC>
-Grid<NDim, VCC>::Grid(
-  TrajectoryN<NDim> const &traj, std::string const ktype, float const osamp, Index const nC, Basis::CPtr b, Index const sgW)
+Grid<NDim, VCC>::Grid(TrajectoryN<NDim> const &traj,
+                      std::string const        ktype,
+                      float const              osamp,
+                      Index const              nC,
+                      Basis::CPtr              b,
+                      Index const              sgW,
+                      Index const              tableMB)
   : Parent(fmt::format("{}D GridOp{}", NDim, VCC ? " VCC" : ""))
   , kernel{KernelBase<Scalar, NDim>::Make(ktype, osamp)}
-  , subgridW{sgW + 2 * (kernel->paddedWidth() / 2)}
+  , subgridSize{sgW}
   , basis{b}
 {
   static_assert(NDim < 4);
+  if (subgridSize == Autotune) { tune(traj, ktype, osamp, nC, tableMB); }
+  subgridW = subgridSize + 2 * (kernel->paddedWidth() / 2);
 
-  auto const m = CalcMapping(traj, osamp, kernel->paddedWidth(), sgW);
-  mappings = m.mappings;
+  auto m = CachedMapping(traj, osamp, kernel->paddedWidth(), subgridSize);
+  mappings = std::move(m.mappings);
+  subgrids = std::move(m.subgrids);
+  colours = ColourSubgrids(subgrids, m.cartDims, kernel->paddedWidth(), subgridSize);
   ishape = AddVCC<VCC>(m.cartDims, nC, basis ? basis->nB() : 1);
   oshape = AddFront(m.noncartDims, nC);
   if constexpr (VCC) {
     Log::Print("Adding VCC");
     auto const conjTraj = TrajectoryN<NDim>(-traj.points(), traj.matrix(), traj.voxelSize());
-    vccMapping = CalcMapping<NDim>(conjTraj, osamp, kernel->paddedWidth(), sgW).mappings;
+    auto vm = CachedMapping<NDim>(conjTraj, osamp, kernel->paddedWidth(), subgridSize);
+    vccMapping = std::move(vm.mappings);
+    vccSubgrids = std::move(vm.subgrids);
+    vccColours = ColourSubgrids(vccSubgrids, m.cartDims, kernel->paddedWidth(), subgridSize);
+  }
+  if (basis && basis->nB() > 1) {
+    SortByEntry(mappings, subgrids, *basis);
+    if constexpr (VCC) { SortByEntry(vccMapping.value(), vccSubgrids, *basis); }
+  }
+  if (tableMB > 0) {
+    Index const MB = WeightsMB<NDim>(mappings.size() + (VCC ? vccMapping.value().size() : 0), kernel->paddedWidth());
+    if (MB <= tableMB) {
+      Log::Print("Precomputing kernel weights, {} MB", MB);
+      weights = KernelWeights(*kernel, mappings);
+      if constexpr (VCC) { vccWeights = KernelWeights(*kernel, vccMapping.value()); }
+    } else {
+      Log::Print("Kernel weights need {} MB, budget is {} MB. Using lookup-table", MB, tableMB);
+      kernel = KernelBase<Scalar, NDim>::Make(ktype, osamp, true);
+    }
   }
   Log::Debug("Grid Dims {}", this->ishape);
 }
 
+/* Precomputed kernel weights for a mapping, or nullptr if the kernel should be evaluated on the fly */
+inline auto MappingWeights(std::vector<float> const &weights, Index const nM, Index const im) -> float const *
+{
+  if (weights.empty()) { return nullptr; }
+  return weights.data() + im * (weights.size() / nM);
+}
+
+/* ParallelFor grain that splits n items into the requested number of blocks per thread */
+inline auto Grain(Index const n, Index const chunks) -> Index
+{
+  return std::max<Index>(1, n / (Threads::GlobalThreadCount() * chunks));
+}
+
+/* Call f(run, first, last) for the part of each subgrid run that overlaps the mapping range [lo, hi) */
+template <int ND, typename F> void ForRuns(std::vector<SubgridRun<ND>> const &runs, Index const lo, Index const hi, F &&f)
+{
+  auto it = std::upper_bound(runs.begin(), runs.end(), lo, [](Index const i, SubgridRun<ND> const &r) { return i < r.start; });
+  for (--it; it != runs.end() && it->start < hi; it++) {
+    f(*it, std::max(lo, it->start), std::min(hi, it->start + it->size));
+  }
+}
+
+/*
+ * Call f(first, last, lo, hi) for each group of consecutive mappings in [first, last) that share a basis entry, where
+ * [lo, hi] is the bounding box of their kernel footprints within the subgrid
+ */
+template <int ND, typename F>
+void ForGroups(std::vector<Mapping<ND>> const &mappings,
+               Index const                     first,
+               Index const                     last,
+               Basis const                    &basis,
+               Index const                     kW,
+               Index const                     sgW,
+               F                             &&f)
+{
+  Index const hW = kW / 2;
+  for (Index gFirst = first; gFirst < last;) {
+    Index const key = EntryKey(mappings[gFirst], basis);
+    Sz<ND>      lo, hi;
+    for (Index id = 0; id < ND; id++) {
+      lo[id] = hi[id] = mappings[gFirst].cart[id];
+    }
+    Index gLast = gFirst + 1;
+    for (; gLast < last && EntryKey(mappings[gLast], basis) == key; gLast++) {
+      for (Index id = 0; id < ND; id++) {
+        lo[id] = std::min<Index>(lo[id], mappings[gLast].cart[id]);
+        hi[id] = std::max<Index>(hi[id], mappings[gLast].cart[id]);
+      }
+    }
+    for (Index id = 0; id < ND; id++) {
+      lo[id] = std::max<Index>(0, lo[id] - hW);
+      hi[id] = std::min<Index>(sgW - 1, hi[id] + hW);
+    }
+    f(gFirst, gLast, lo, hi);
+    gFirst = gLast;
+  }
+}
+
+/* Call f(v0, nV) for each contiguous row of voxels within the box [lo, hi] of a subgrid, where v0 is the first voxel */
+template <int ND, typename F> void ForBoxRows(Sz<ND> const &lo, Sz<ND> const &hi, Index const sgW, F &&f)
+{
+  Index const nV = hi[0] - lo[0] + 1;
+  if constexpr (ND == 1) {
+    f(lo[0], nV);
+  } else if constexpr (ND == 2) {
+    for (Index i1 = lo[1]; i1 <= hi[1]; i1++) {
+      f(lo[0] + sgW * i1, nV);
+    }
+  } else {
+    for (Index i2 = lo[2]; i2 <= hi[2]; i2++) {
+      for (Index i1 = lo[1]; i1 <= hi[1]; i1++) {
+        f(lo[0] + sgW * (i1 + sgW * i2), nV);
+      }
+    }
+  }
+}
+
+/*
+ * Applying the basis per sample costs nB multiplies on every kernel tap. Contracting it once for a group instead costs
+ * one pass over the group's bounding box with nB multiplies per voxel, plus the basis-free taps.
+ */
+template <int ND>
+inline auto FuseGroup(Index const n, Index const taps, Sz<ND> const &lo, Sz<ND> const &hi, Index const nB) -> bool
+{
+  Index box = 1;
+  for (Index id = 0; id < ND; id++) {
+    box *= hi[id] - lo[id] + 1;
+  }
+  return n * taps * (nB - 1) > box * (nB + 1);
+}
+
+/* s(c, v) = sum_b b(b) x(b, c, v) over the box, a vector-matrix product per row of voxels */
+template <int ND>
+void ProjectBasis(Cx1CMap const &b, CxNCMap<ND + 2> const &sx, CxNMap<ND + 2> &s1, Sz<ND> const &lo, Sz<ND> const &hi)
+{
+  Index const                           nB = sx.dimension(0);
+  Index const                           nC = sx.dimension(1);
+  Eigen::Map<Eigen::RowVectorXcf const> bv(b.data(), nB);
+  ForBoxRows<ND>(lo, hi, sx.dimension(2), [&](Index const v0, Index const nV) {
+    Eigen::Map<Eigen::MatrixXcf const> X(sx.data() + v0 * nB * nC, nB, nC * nV);
+    Eigen::Map<Eigen::RowVectorXcf>    S(s1.data() + v0 * nC, nC * nV);
+    S.noalias() = bv * X;
+  });
+}
+
+/* x(b, c, v) += conj(b(b)) s(c, v) over the box, a rank-1 update per row of voxels. Clears s ready for the next group. */
+template <int ND>
+void ExpandBasis(Cx1CMap const &b, CxNMap<ND + 2> &s1, CxNMap<ND + 2> &sx, Sz<ND> const &lo, Sz<ND> const &hi)
+{
+  Index const                        nB = sx.dimension(0);
+  Index const                        nC = sx.dimension(1);
+  Eigen::Map<Eigen::VectorXcf const> bv(b.data(), nB);
+  ForBoxRows<ND>(lo, hi, sx.dimension(2), [&](Index const v0, Index const nV) {
+    Eigen::Map<Eigen::MatrixXcf>    X(sx.data() + v0 * nB * nC, nB, nC * nV);
+    Eigen::Map<Eigen::RowVectorXcf> S(s1.data() + v0 * nC, nC * nV);
+    X.noalias() += bv.conjugate() * S;
+    S.setZero();
+  });
+}
+
+template <int ND>
+inline void GatherMapping(Mapping<ND> const                      &m,
+                          float const                            *k,
+                          Basis::CPtr const                      &basis,
+                          typename KernelBase<Cx, ND>::Ptr const &kernel,
+                          CxNCMap<ND + 2> const                  &sx,
+                          CxNMap<3>                              &y,
+                          Index const                             c0)
+{
+  Cx1Map yy(&y(c0, m.sample, m.trace), Sz1{sx.dimension(1)});
+  if (basis) {
+    if (k) {
+      kernel->gather(m.cart, k, basis->entry(m.sample, m.trace), sx, yy);
+    } else {
+      kernel->gather(m.cart, m.offset, basis->entry(m.sample, m.trace), sx, yy);
+    }
+  } else {
+    if (k) {
+      kernel->gather(m.cart, k, sx, yy);
+    } else {
+      kernel->gather(m.cart, m.offset, sx, yy);
+    }
+  }
+}
+
+/*
+ * Gather the mappings [first, last) from the subgrid. With a basis scratch subgrid s1, groups of mappings that share a
+ * basis entry are gathered from the projection of sx onto that entry where that is cheaper.
+ */
+template <int ND>
+void GatherRun(std::vector<Mapping<ND>> const         &mappings,
+               Index const                             first,
+               Index const                             last,
+               std::vector<float> const               &weights,
+               Basis::CPtr const                      &basis,
+               typename KernelBase<Cx, ND>::Ptr const &kernel,
+               CxNCMap<ND + 2> const                  &sx,
+               CxNMap<ND + 2>                         *s1,
+               CxNMap<3>                              &y,
+               Index const                             c0)
+{
+  Index const nM = mappings.size();
+  if (!s1) {
+    for (Index im = first; im < last; im++) {
+      GatherMapping(mappings[im], MappingWeights(weights, nM, im), basis, kernel, sx, y, c0);
+    }
+    return;
+  }
+  Index const           kW = kernel->paddedWidth();
+  Index const           taps = std::pow(kW, ND);
+  Basis::CPtr           none = nullptr;
+  Index const           sgW = sx.dimension(2);
+  CxNCMap<ND + 2> const cs1(s1->data(), s1->dimensions());
+  ForGroups(mappings, first, last, *basis, kW, sgW, [&](Index const gF, Index const gL, Sz<ND> const &lo, Sz<ND> const &hi) {
+    if (FuseGroup<ND>(gL - gF, taps, lo, hi, basis->nB())) {
+      ProjectBasis<ND>(basis->entry(mappings[gF].sample, mappings[gF].trace), sx, *s1, lo, hi);
+      for (Index im = gF; im < gL; im++) {
+        GatherMapping(mappings[im], MappingWeights(weights, nM, im), none, kernel, cs1, y, c0);
+      }
+    } else {
+      for (Index im = gF; im < gL; im++) {
+        GatherMapping(mappings[im], MappingWeights(weights, nM, im), basis, kernel, sx, y, c0);
+      }
+    }
+  });
+}
+
 /* Needs to be a functor to avoid template errors */
 template <int ND, bool hasVCC, bool isVCC> struct forwardTask
 {
-  void operator()(std::span<Mapping<ND> const> const &mappings,
-                  Index const                         subgridW,
+  void operator()(Index const                         lo,
+                  Index const                         hi,
+                  std::vector<Mapping<ND>> const     &mappings,
+                  std::vector<SubgridRun<ND>> const  &runs,
+                  std::vector<float> const           &weights,
                   Basis::CPtr const                  &basis,
                   KernelBase<Cx, ND>::Ptr const      &kernel,
                   CxNCMap<ND + 2 + hasVCC> const     &x,
-                  CxNMap<3>                          &y) const
+                  CxNMap<3>                          &y,
+                  Index const                         c0,
+                  CxNMap<ND + 2>                     &sx,
+                  CxNMap<ND + 2>                     *s1) const
   {
-    Index const nC = y.dimension(0);
-    Index const nB = basis ? basis->nB() : 1;
-    CxN<ND + 2> sx(AddFront(Constant<ND>(subgridW), nB, nC));
-    Sz<ND>      current = mappings.front().subgrid;
-    GridToSubgrid<ND, hasVCC, isVCC>(current, x, sx);
-    for (auto const &m : mappings) {
-      if (current != m.subgrid) {
-        current = m.subgrid;
-        GridToSubgrid<ND, hasVCC, isVCC>(current, x, sx);
-      }
-      Eigen::TensorMap<Eigen::Tensor<Cx, 1>> yy(&y(0, m.sample, m.trace), Sz1{nC});
-      if (basis) {;
-        kernel->gather(m.cart, m.offset, basis->entry(m.sample, m.trace), sx, yy);
-      } else {
-        kernel->gather(m.cart, m.offset, sx, yy);
-      }
-    }
+    CxNCMap<ND + 2> const csx(sx.data(), sx.dimensions());
+    ForRuns(runs, lo, hi, [&](SubgridRun<ND> const &run, Index const first, Index const last) {
+      GridToSubgrid<ND, hasVCC, isVCC>(run.subgrid, x, sx);
+      GatherRun(mappings, first, last, weights, basis, kernel, csx, s1, y, c0);
+    });
   }
 };
 
+template <int ND, bool VCC, bool isVCC>
+void Forward(std::vector<Mapping<ND>> const         &mappings,
+             std::vector<SubgridRun<ND>> const      &runs,
+             std::vector<float> const               &weights,
+             Index const                             subgridW,
+             Index const                             chunks,
+             bool const                              fused,
+             Basis::CPtr const                      &basis,
+             typename KernelBase<Cx, ND>::Ptr const &kernel,
+             CxNCMap<ND + 2 + VCC> const            &x,
+             CxNMap<3>                              &y,
+             Index const                             c0 = 0)
+{
+  Scratch<ND> scratch(subgridW, fused, basis, x.dimension(1));
+  Threads::ParallelFor(0, mappings.size(), Grain(mappings.size(), chunks), [&](Index const lo, Index const hi, Index const iw) {
+    forwardTask<ND, VCC, isVCC>()(lo, hi, mappings, runs, weights, basis, kernel, x, y, c0, scratch.sx[iw],
+                                  scratch.worker1(iw));
+  });
+}
+
 template <int NDim, bool VCC> void Grid<NDim, VCC>::forward(InCMap const &x, OutMap &y) const
 {
   auto const time = this->startForward(x, y, false);
   y.device(Threads::GlobalDevice()) = y.constant(0.f);
-  Threads::ChunkFor(forwardTask<NDim, VCC, false>(), this->mappings, subgridW, this->basis, this->kernel, x, y);
+  Forward<NDim, VCC, false>(this->mappings, subgrids, weights, subgridW, chunks, fused, this->basis, this->kernel, x, y);
   if constexpr (VCC == true) {
-    Threads::ChunkFor(forwardTask<NDim, VCC, true>(), this->vccMapping.value(), subgridW, this->basis, this->kernel, x, y);
+    Forward<NDim, VCC, true>(this->vccMapping.value(), vccSubgrids, vccWeights, subgridW, chunks, fused, this->basis,
+                             this->kernel, x, y);
   }
   this->finishForward(y, time, false);
 }
@@ -105,59 +429,181 @@ template <int NDim, bool VCC> void Grid<NDim, VCC>::forward(InCMap const &x, Out
 template <int NDim, bool VCC> void Grid<NDim, VCC>::iforward(InCMap const &x, OutMap &y) const
 {
   auto const time = this->startForward(x, y, true);
-  Threads::ChunkFor(forwardTask<NDim, VCC, false>(), this->mappings, subgridW, this->basis, this->kernel, x, y);
+  Forward<NDim, VCC, false>(this->mappings, subgrids, weights, subgridW, chunks, fused, this->basis, this->kernel, x, y);
   if constexpr (VCC == true) {
-    Threads::ChunkFor(forwardTask<NDim, VCC, true>(), this->vccMapping.value(), subgridW, this->basis, this->kernel, x, y);
+    Forward<NDim, VCC, true>(this->vccMapping.value(), vccSubgrids, vccWeights, subgridW, chunks, fused, this->basis,
+                             this->kernel, x, y);
   }
   this->finishForward(y, time, true);
 }
 
-template <int ND, bool hasVCC, bool isVCC> struct adjointTask
+template <int NDim, bool VCC> void Grid<NDim, VCC>::iforwardBatch(InCMap const &x, CxNMap<3> &y, Index const c0) const
 {
-  void operator()(std::span<Mapping<ND> const> const &mappings,
-                  std::mutex                         &writeMutex,
-                  Index const                         subgridW,
-                  Basis::CPtr const                  &basis,
-                  KernelBase<Cx, ND>::Ptr const      &kernel,
-                  CxNCMap<3> const                   &y,
-                  CxNMap<ND + 2 + hasVCC>            &x) const
-  {
-    Index const nC = y.dimensions()[0];
-    Index const nB = basis ? basis->nB() : 1;
-    CxN<ND + 2> sx(AddFront(Constant<ND>(subgridW), nB, nC));
-    sx.setZero();
-    Sz<ND> current = mappings.front().subgrid;
-    for (auto const &m : mappings) {
-      if (current != m.subgrid) {
-        std::scoped_lock lock(writeMutex);
-        SubgridToGrid<ND, hasVCC, isVCC>(current, sx, x);
-        sx.setZero();
-        current = m.subgrid;
+  if (x.dimensions() != ishape || y.dimension(0) < c0 + oshape[0] || y.dimension(1) != oshape[1] ||
+      y.dimension(2) != oshape[2]) {
+    Log::Fail("{} batch x {} y {} channel {} did not match {}->{}", this->name, x.dimensions(), y.dimensions(), c0, ishape,
+              oshape);
+  }
+  Forward<NDim, VCC, false>(this->mappings, subgrids, weights, subgridW, chunks, fused, this->basis, this->kernel, x, y,
+                            c0);
+  if constexpr (VCC == true) {
+    Forward<NDim, VCC, true>(this->vccMapping.value(), vccSubgrids, vccWeights, subgridW, chunks, fused, this->basis,
+                             this->kernel, x, y, c0);
+  }
+}
+
+template <int ND>
+inline void SpreadMapping(Mapping<ND> const                      &m,
+                          float const                            *k,
+                          Basis::CPtr const                      &basis,
+                          typename KernelBase<Cx, ND>::Ptr const &kernel,
+                          CxNCMap<3> const                       &y,
+                          Index const                             c0,
+                          CxNMap<ND + 2>                         &sx)
+{
+  Cx1CMap yy(&y(c0, m.sample, m.trace), Sz1{sx.dimension(1)});
+  if (basis) {
+    if (k) {
+      kernel->spread(m.cart, k, basis->entry(m.sample, m.trace), yy, sx);
+    } else {
+      kernel->spread(m.cart, m.offset, basis->entry(m.sample, m.trace), yy, sx);
+    }
+  } else {
+    if (k) {
+      kernel->spread(m.cart, k, yy, sx);
+    } else {
+      kernel->spread(m.cart, m.offset, yy, sx);
+    }
+  }
+}
+
+/* Spread the mappings [first, last) into the subgrid, grouping by basis entry if there is a scratch subgrid s1 */
+template <int ND>
+void SpreadRun(std::vector<Mapping<ND>> const         &mappings,
+               Index const                             first,
+               Index const                             last,
+               std::vector<float> const               &weights,
+               Basis::CPtr const                      &basis,
+               typename KernelBase<Cx, ND>::Ptr const &kernel,
+               CxNCMap<3> const                       &y,
+               Index const                             c0,
+               CxNMap<ND + 2>                         &sx,
+               CxNMap<ND + 2>                         *s1)
+{
+  Index const nM = mappings.size();
+  if (!s1) {
+    for (Index im = first; im < last; im++) {
+      SpreadMapping(mappings[im], MappingWeights(weights, nM, im), basis, kernel, y, c0, sx);
+    }
+    return;
+  }
+  Index const kW = kernel->paddedWidth();
+  Index const taps = std::pow(kW, ND);
+  Basis::CPtr none = nullptr;
+  Index const sgW = sx.dimension(2);
+  ForGroups(mappings, first, last, *basis, kW, sgW, [&](Index const gF, Index const gL, Sz<ND> const &lo, Sz<ND> const &hi) {
+    if (FuseGroup<ND>(gL - gF, taps, lo, hi, basis->nB())) {
+      for (Index im = gF; im < gL; im++) {
+        SpreadMapping(mappings[im], MappingWeights(weights, nM, im), none, kernel, y, c0, *s1);
       }
-      Eigen::Tensor<Cx, 1> yy = y.template chip<2>(m.trace).template chip<1>(m.sample);
-      if (basis) {
-        kernel->spread(m.cart, m.offset, basis->entryConj(m.sample, m.trace), yy, sx);
-      } else {
-        kernel->spread(m.cart, m.offset, yy, sx);
+      ExpandBasis<ND>(basis->entry(mappings[gF].sample, mappings[gF].trace), *s1, sx, lo, hi);
+    } else {
+      for (Index im = gF; im < gL; im++) {
+        SpreadMapping(mappings[im], MappingWeights(weights, nM, im), basis, kernel, y, c0, sx);
       }
     }
+  });
+}
 
-    {
+template <int ND, bool hasVCC, bool isVCC> struct adjointTask
+{
+  void operator()(Index const                        lo,
+                  Index const                        hi,
+                  std::vector<Mapping<ND>> const    &mappings,
+                  std::vector<SubgridRun<ND>> const &runs,
+                  std::vector<float> const          &weights,
+                  std::mutex                        &writeMutex,
+                  Basis::CPtr const                 &basis,
+                  KernelBase<Cx, ND>::Ptr const     &kernel,
+                  CxNCMap<3> const                  &y,
+                  CxNMap<ND + 2 + hasVCC>           &x,
+                  Index const                        c0,
+                  CxNMap<ND + 2>                    &sx,
+                  CxNMap<ND + 2>                    *s1) const
+  {
+    ForRuns(runs, lo, hi, [&](SubgridRun<ND> const &run, Index const first, Index const last) {
+      sx.setZero();
+      SpreadRun(mappings, first, last, weights, basis, kernel, y, c0, sx, s1);
       std::scoped_lock lock(writeMutex);
-      SubgridToGrid<ND, hasVCC, isVCC>(current, sx, x);
+      SubgridToGrid<ND, hasVCC, isVCC>(run.subgrid, CxNCMap<ND + 2>(sx.data(), sx.dimensions()), x);
+    });
+  }
+};
+
+/* Subgrids within a colour never overlap, so can be written back without the mutex */
+template <int ND, bool hasVCC, bool isVCC> struct adjointColourTask
+{
+  void operator()(std::span<SubgridRun<ND> const> const &runs,
+                  std::vector<Mapping<ND>> const        &mappings,
+                  std::vector<float> const              &weights,
+                  Basis::CPtr const                     &basis,
+                  KernelBase<Cx, ND>::Ptr const         &kernel,
+                  CxNCMap<3> const                      &y,
+                  CxNMap<ND + 2 + hasVCC>               &x,
+                  Index const                            c0,
+                  CxNMap<ND + 2>                        &sx,
+                  CxNMap<ND + 2>                        *s1) const
+  {
+    for (auto const &run : runs) {
+      sx.setZero();
+      SpreadRun(mappings, run.start, run.start + run.size, weights, basis, kernel, y, c0, sx, s1);
+      SubgridToGrid<ND, hasVCC, isVCC>(run.subgrid, CxNCMap<ND + 2>(sx.data(), sx.dimensions()), x);
     }
   }
 };
 
+template <int ND, bool VCC, bool isVCC>
+void Adjoint(std::vector<Mapping<ND>> const                 &mappings,
+             std::vector<SubgridRun<ND>> const              &runs,
+             std::vector<float> const                       &weights,
+             std::vector<std::vector<SubgridRun<ND>>> const &colours,
+             bool const                                      coloured,
+             Index const                                     subgridW,
+             Index const                                     chunks,
+             bool const                                      fused,
+             Basis::CPtr const                              &basis,
+             typename KernelBase<Cx, ND>::Ptr const         &kernel,
+             CxNCMap<3> const                               &y,
+             CxNMap<ND + 2 + VCC>                           &x,
+             Index const                                     c0 = 0)
+{
+  Scratch<ND> scratch(subgridW, fused, basis, x.dimension(1));
+  if (coloured) {
+    for (auto const &colour : colours) {
+      Threads::ParallelFor(0, colour.size(), Grain(colour.size(), chunks), [&](Index const lo, Index const hi, Index const iw) {
+        adjointColourTask<ND, VCC, isVCC>()(std::span(colour).subspan(lo, hi - lo), mappings, weights, basis, kernel, y, x,
+                                            c0, scratch.sx[iw], scratch.worker1(iw));
+      });
+    }
+  } else {
+    std::mutex writeMutex;
+    Threads::ParallelFor(0, mappings.size(), Grain(mappings.size(), chunks),
+                         [&](Index const lo, Index const hi, Index const iw) {
+                           adjointTask<ND, VCC, isVCC>()(lo, hi, mappings, runs, weights, writeMutex, basis, kernel, y, x, c0,
+                                                         scratch.sx[iw], scratch.worker1(iw));
+                         });
+  }
+}
+
 template <int NDim, bool VCC> void Grid<NDim, VCC>::adjoint(OutCMap const &y, InMap &x) const
 {
   auto const time = this->startAdjoint(y, x, false);
   x.device(Threads::GlobalDevice()) = x.constant(0.f);
-  std::mutex writeMutex;
-  Threads::ChunkFor(adjointTask<NDim, VCC, false>(), this->mappings, writeMutex, subgridW, this->basis, this->kernel, y, x);
+  Adjoint<NDim, VCC, false>(this->mappings, subgrids, weights, colours, coloured, subgridW, chunks, fused, this->basis,
+                            this->kernel, y, x);
   if constexpr (VCC == true) {
-    Threads::ChunkFor(adjointTask<NDim, VCC, true>(), this->vccMapping.value(), writeMutex, subgridW, this->basis, this->kernel,
-                      y, x);
+    Adjoint<NDim, VCC, true>(this->vccMapping.value(), vccSubgrids, vccWeights, vccColours, coloured, subgridW, chunks, fused,
+                             this->basis, this->kernel, y, x);
   }
   this->finishAdjoint(x, time, false);
 }
@@ -165,15 +611,130 @@ template <int NDim, bool VCC> void Grid<NDim, VCC>::adjoint(OutCMap const &y, In
 template <int NDim, bool VCC> void Grid<NDim, VCC>::iadjoint(OutCMap const &y, InMap &x) const
 {
   auto const time = this->startAdjoint(y, x, true);
-  std::mutex writeMutex;
-  Threads::ChunkFor(adjointTask<NDim, VCC, false>(), this->mappings, writeMutex, subgridW, this->basis, this->kernel, y, x);
+  Adjoint<NDim, VCC, false>(this->mappings, subgrids, weights, colours, coloured, subgridW, chunks, fused, this->basis,
+                            this->kernel, y, x);
   if constexpr (VCC == true) {
-    Threads::ChunkFor(adjointTask<NDim, VCC, true>(), this->vccMapping.value(), writeMutex, subgridW, this->basis,
-                      this->kernel, y, x);
+    Adjoint<NDim, VCC, true>(this->vccMapping.value(), vccSubgrids, vccWeights, vccColours, coloured, subgridW, chunks, fused,
+                             this->basis, this->kernel, y, x);
   }
   this->finishAdjoint(x, time, true);
 }
 
+template <int NDim, bool VCC> void Grid<NDim, VCC>::adjointBatch(CxNCMap<3> const &y, InMap &x, Index const c0) const
+{
+  if (x.dimensions() != ishape || y.dimension(0) < c0 + oshape[0] || y.dimension(1) != oshape[1] ||
+      y.dimension(2) != oshape[2]) {
+    Log::Fail("{} batch y {} x {} channel {} did not match {}->{}", this->name, y.dimensions(), x.dimensions(), c0, oshape,
+              ishape);
+  }
+  x.device(Threads::GlobalDevice()) = x.constant(0.f);
+  Adjoint<NDim, VCC, false>(this->mappings, subgrids, weights, colours, coloured, subgridW, chunks, fused, this->basis,
+                            this->kernel, y, x, c0);
+  if constexpr (VCC == true) {
+    Adjoint<NDim, VCC, true>(this->vccMapping.value(), vccSubgrids, vccWeights, vccColours, coloured, subgridW, chunks, fused,
+                             this->basis, this->kernel, y, x, c0);
+  }
+}
+
+/*
+ * Benchmark the forward and adjoint over a sample of the subgrid runs for each candidate subgrid size and chunk count,
+ * and keep the fastest. Runs are sampled at a stride rather than by trajectory so the density of samples per subgrid,
+ * which decides the trade-off between halo overhead and cache footprint, is the same as in the full problem.
+ */
+template <int NDim, bool VCC>
+void Grid<NDim, VCC>::tune(
+  TrajectoryN<NDim> const &traj, std::string const &ktype, float const osamp, Index const nC, Index const tableMB)
+{
+  Index constexpr version = 2;
+  Index const     kW = kernel->paddedWidth();
+  Index const     nB = basis ? basis->nB() : 1;
+  Index const     nT = Threads::GlobalThreadCount();
+  Cache::Key      key;
+  key.add(version).add(NDim).add(VCC).add(traj.points().data(), traj.points().size()).add(traj.matrix()).add(osamp);
+  key.add(ktype).add(nC).add(nB).add(nT).add(tableMB);
+  if (auto const path = Cache::Lookup("grid-tune", key)) {
+    try {
+      auto const meta = HD5::Reader(path.value()).readMeta();
+      if (meta.contains("subgridSize") && meta.contains("chunks")) {
+        subgridSize = static_cast<Index>(meta.at("subgridSize"));
+        chunks = static_cast<Index>(meta.at("chunks"));
+        Log::Print("Cached gridding subgrid size {} chunks {}", subgridSize, chunks);
+        return;
+      }
+      Log::Warn("Cached grid tuning was incomplete, re-tuning");
+    } catch (Log::Failure const &) {
+      Log::Warn("Could not read cached grid tuning, re-tuning");
+    }
+  }
+
+  Index constexpr nSample = 1 << 18;
+  Index constexpr nRepeat = 3;
+  auto const      t0 = Log::Now();
+  InTensor        x;
+  OutTensor       y;
+  float           best = std::numeric_limits<float>::infinity();
+  for (Index const sg : {8, 16, 32, 64}) {
+    auto m = CalcMapping(traj, osamp, kW, sg);
+    if (m.mappings.empty()) { continue; }
+    if (x.size() == 0) {
+      x.resize(AddVCC<VCC>(m.cartDims, nC, nB));
+      x.setZero();
+      y.resize(AddFront(m.noncartDims, nC));
+      y.setZero();
+    }
+    Index const                   stride = std::max<Index>(1, m.mappings.size() / nSample);
+    std::vector<Mapping<NDim>>    sampled;
+    std::vector<SubgridRun<NDim>> runs;
+    for (size_t ir = 0; ir < m.subgrids.size(); ir += stride) {
+      auto const &run = m.subgrids[ir];
+      runs.push_back(SubgridRun<NDim>{run.subgrid, static_cast<Index>(sampled.size()), run.size});
+      sampled.insert(sampled.end(), m.mappings.begin() + run.start, m.mappings.begin() + run.start + run.size);
+    }
+    if (basis && basis->nB() > 1) { SortByEntry(sampled, runs, *basis); }
+    /* Time the kernel configuration the constructor will pick: precomputed weights, or the lookup-table kernel */
+    std::vector<float> sampledWeights;
+    auto               tuneKernel = kernel;
+    if (tableMB > 0) {
+      if (WeightsMB<NDim>(m.mappings.size() * (VCC ? 2 : 1), kW) <= tableMB) {
+        sampledWeights = KernelWeights(*kernel, sampled);
+      } else {
+        tuneKernel = KernelBase<Scalar, NDim>::Make(ktype, osamp, true);
+      }
+    }
+    auto const  runColours = ColourSubgrids(runs, m.cartDims, kW, sg);
+    Index const sgW = sg + 2 * (kW / 2);
+    InCMap      xm(x.data(), x.dimensions());
+    InMap       xxm(x.data(), x.dimensions());
+    OutCMap     ym(y.data(), y.dimensions());
+    OutMap      yym(y.data(), y.dimensions());
+    for (Index const ch : {4, 16, 64}) {
+      float t = std::numeric_limits<float>::infinity();
+      for (Index ir = 0; ir < nRepeat; ir++) {
+        auto const start = Log::Now();
+        Forward<NDim, VCC, false>(sampled, runs, sampledWeights, sgW, ch, fused, basis, tuneKernel, xm, yym);
+        Adjoint<NDim, VCC, false>(sampled, runs, sampledWeights, runColours, coloured, sgW, ch, fused, basis, tuneKernel, ym,
+                                  xxm);
+        t = std::min(t, std::chrono::duration<float>(Log::Now() - start).count());
+      }
+      Log::Debug("Subgrid size {} chunks {} time {:.3f}s", sg, ch, t);
+      if (t < best) {
+        best = t;
+        subgridSize = sg;
+        chunks = ch;
+      }
+    }
+  }
+  if (subgridSize == Autotune) {
+    Log::Warn("Trajectory had no samples to tune gridding on, using defaults");
+    subgridSize = 32;
+    return;
+  }
+  Log::Print("Tuned gridding subgrid size {} chunks {} in {}", subgridSize, chunks, Log::ToNow(t0));
+  Cache::Store("grid-tune", key, [this](HD5::Writer &writer) {
+    writer.writeMeta({{"subgridSize", static_cast<float>(subgridSize)}, {"chunks", static_cast<float>(chunks)}});
+  });
+}
+
 template struct Grid<1, false>;
 template struct Grid<2, false>;
 template struct Grid<3, false>;
@@ -16,7 +16,8 @@ struct GridOpts
   args::ValueFlag<std::string> ktype;
   args::ValueFlag<float>       osamp;
   args::Flag                   vcc;
-  args::ValueFlag<Index>       batches, subgridSize;
+  args::ValueFlag<Index>       batches, subgridSize, kTable;
+  args::ValueFlag<std::string> precision;
 };
 
 namespace TOps {
@@ -25,20 +26,46 @@ template <int ND, bool VCC = false> struct Grid final : TOp<Cx, ND + 2 + VCC, 3>
   TOP_INHERIT(Cx, ND + 2 + VCC, 3)
   using Parent::adjoint;
   using Parent::forward;
-  std::shared_ptr<KernelBase<Scalar, ND>> kernel;
-  Index                                   subgridW;
-  std::vector<Mapping<ND>>                mappings;
-  Basis::CPtr                             basis;
-  std::optional<std::vector<Mapping<ND>>> vccMapping;
-
-  static auto
-  Make(TrajectoryN<ND> const &t, std::string const kt, float const os, Index const nC, Basis::CPtr b, Index const sgW = 32)
-    -> std::shared_ptr<Grid<ND, VCC>>;
-  Grid(TrajectoryN<ND> const &traj, std::string const ktype, float const osamp, Index const nC, Basis::CPtr b, Index const sgW);
+  std::shared_ptr<KernelBase<Scalar, ND>>  kernel;
+  Index                                    subgridSize, subgridW; // Subgrid size, and width including kernel halo
+  Index                                    chunks = 16;           // Parallel blocks per thread
+  std::vector<Mapping<ND>>                 mappings;
+  std::vector<SubgridRun<ND>>              subgrids;
+  Basis::CPtr                              basis;
+  std::optional<std::vector<Mapping<ND>>>  vccMapping;
+  std::vector<SubgridRun<ND>>              vccSubgrids;
+  std::vector<std::vector<SubgridRun<ND>>> colours, vccColours;
+  bool                                     coloured = true; // Lock-free colour-by-colour adjoint, otherwise use a mutex
+  bool                                     fused = true;    // Contract the basis once per group of samples sharing an entry
+  std::vector<float>                       weights, vccWeights; // Precomputed kernel weights per mapping, can be empty
+
+  static Index constexpr Autotune = 0; // Pass as the subgrid size to benchmark candidate sizes and chunks at construction
+
+  static auto Make(TrajectoryN<ND> const &t,
+                   std::string const      kt,
+                   float const            os,
+                   Index const            nC,
+                   Basis::CPtr            b,
+                   Index const            sgW = 32,
+                   Index const            tableMB = 0) -> std::shared_ptr<Grid<ND, VCC>>;
+  Grid(TrajectoryN<ND> const &traj,
+       std::string const      ktype,
+       float const            osamp,
+       Index const            nC,
+       Basis::CPtr            b,
+       Index const            sgW,
+       Index const            tableMB);
   void forward(InCMap const &x, OutMap &y) const;
   void adjoint(OutCMap const &y, InMap &x) const;
   void iforward(InCMap const &x, OutMap &y) const;
   void iadjoint(OutCMap const &y, InMap &x) const;
+
+  /* Channel batches. y holds all channels and the batch occupies [c0, c0 + oshape[0]). The forward adds into y. */
+  void iforwardBatch(InCMap const &x, CxNMap<3> &y, Index const c0) const;
+  void adjointBatch(CxNCMap<3> const &y, InMap &x, Index const c0) const;
+
+private:
+  void tune(TrajectoryN<ND> const &traj, std::string const &ktype, float const osamp, Index const nC, Index const tableMB);
 };
 
 } // namespace TOps
@@ -3,9 +3,25 @@
 #include "ops.hpp"
 
 #include "log.hpp"
+#include "threads.hpp"
 
 namespace rl::TOps {
 
+/*
+ * Applies Op to each of N frames (time points, slabs) stacked along the last dimension.
+ *
+ * Frames can run either one after another, with Op parallelising internally, or concurrently with each frame run
+ * serially on one thread. Operators lease their scratch space from the per-thread Arena so concurrent frames do not
+ * share workspaces. Concurrent frames need one workspace per thread, so by default they are only used when each frame is
+ * small enough that the inner operator would not keep the pool busy by itself.
+ */
+enum struct LoopMode
+{
+  Auto,
+  Inner,
+  Outer
+};
+
 template <typename Op> struct Loop final : TOp<typename Op::Scalar, Op::InRank + 1, Op::OutRank + 1>
 {
   TOP_INHERIT(typename Op::Scalar, Op::InRank + 1, Op::OutRank + 1)
@@ -13,11 +29,20 @@ template <typename Op> struct Loop final : TOp<typename Op::Scalar, Op::InRank +
   using Parent::forward;
   using Ptr = std::shared_ptr<Loop>;
 
-  Loop(std::shared_ptr<Op> op, Index const N)
+  static constexpr Index OuterThreshold = 1 << 20; // Elements per frame below which frames run concurrently
+
+  Loop(std::shared_ptr<Op> op, Index const N, LoopMode const mode = LoopMode::Auto)
     : Parent("Loop", AddBack(op->ishape, N), AddBack(op->oshape, N))
     , op_{op}
     , N_{N}
   {
+    Index const frame = std::max(Product(op_->ishape), Product(op_->oshape));
+    switch (mode) {
+    case LoopMode::Auto: outer_ = N_ > 1 && frame < OuterThreshold; break;
+    case LoopMode::Inner: outer_ = false; break;
+    case LoopMode::Outer: outer_ = N_ > 1; break;
+    }
+    Log::Debug("Loop {} frames of {} elements {}", N_, frame, outer_ ? "concurrently" : "sequentially");
   }
 
   void forward(InCMap const &x, OutMap &y) const
@@ -25,11 +50,11 @@ template <typename Op> struct Loop final : TOp<typename Op::Scalar, Op::InRank +
     assert(x.dimensions() == this->ishape);
     assert(y.dimensions() == this->oshape);
     auto const time = this->startForward(x, y, false);
-    for (Index ii = 0; ii < N_; ii++) {
+    frames([&](Index const ii) {
       typename Op::InCMap xchip(x.data() + Product(op_->ishape) * ii, op_->ishape);
       typename Op::OutMap ychip(y.data() + Product(op_->oshape) * ii, op_->oshape);
       op_->forward(xchip, ychip);
-    }
+    });
     this->finishForward(y, time, false);
   }
 
@@ -38,12 +63,11 @@ template <typename Op> struct Loop final : TOp<typename Op::Scalar, Op::InRank +
     assert(x.dimensions() == this->ishape);
     assert(y.dimensions() == this->oshape);
     auto const time = this->startAdjoint(y, x, false);
-    for (Index ii = 0; ii < N_; ii++) {
+    frames([&](Index const ii) {
       typename Op::OutCMap ychip(y.data() + Product(op_->oshape) * ii, op_->oshape);
       typename Op::InMap   xchip(x.data() + Product(op_->ishape) * ii, op_->ishape);
-      Log::Debug("Loop op {}/{}", ii, N_);
       op_->adjoint(ychip, xchip);
-    }
+    });
     this->finishAdjoint(x, time, false);
   }
 
@@ -52,11 +76,11 @@ template <typename Op> struct Loop final : TOp<typename Op::Scalar, Op::InRank +
     assert(x.dimensions() == this->ishape);
     assert(y.dimensions() == this->oshape);
     auto const time = this->startForward(x, y, true);
-    for (Index ii = 0; ii < N_; ii++) {
+    frames([&](Index const ii) {
       typename Op::InCMap xchip(x.data() + Product(op_->ishape) * ii, op_->ishape);
       typename Op::OutMap ychip(y.data() + Product(op_->oshape) * ii, op_->oshape);
       op_->iforward(xchip, ychip);
-    }
+    });
     this->finishForward(y, time, true);
   }
 
@@ -65,25 +89,35 @@ template <typename Op> struct Loop final : TOp<typename Op::Scalar, Op::InRank +
     assert(x.dimensions() == this->ishape);
     assert(y.dimensions() == this->oshape);
     auto const time = this->startAdjoint(y, x, true);
-    for (Index ii = 0; ii < N_; ii++) {
+    frames([&](Index const ii) {
       typename Op::OutCMap ychip(y.data() + Product(op_->oshape) * ii, op_->oshape);
       typename Op::InMap   xchip(x.data() + Product(op_->ishape) * ii, op_->ishape);
-      Log::Debug("Loop op {}/{}", ii, N_);
       op_->iadjoint(ychip, xchip);
-    }
+    });
     this->finishAdjoint(x, time, true);
   }
 
 private:
+  void frames(Threads::ForFunc const &f) const
+  {
+    if (outer_) {
+      Threads::For(f, N_);
+    } else {
+      for (Index ii = 0; ii < N_; ii++) {
+        f(ii);
+      }
+    }
+  }
+
   std::shared_ptr<Op> op_;
   Index               N_;
+  bool                outer_;
 };
 
 template <typename Op>
-auto MakeLoop(std::shared_ptr<Op> op, Index const N) -> Loop<Op>::Ptr
+auto MakeLoop(std::shared_ptr<Op> op, Index const N, LoopMode const mode = LoopMode::Auto) -> Loop<Op>::Ptr
 {
-  return std::make_shared<Loop<Op>>(op, N);
+  return std::make_shared<Loop<Op>>(op, N, mode);
 }
 
-
 } // namespace rl::TOps
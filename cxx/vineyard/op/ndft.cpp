@@ -99,7 +99,14 @@ template <int NDim> void NDFT<NDim>::forward(InCMap const &x, OutMap &y) const
       y.template chip<2>(itr).template chip<1>(isamp) = samp * Cx(scale);
     }
   };
-  Threads::For(task, nTrace, "NDFT Forward");
+  Threads::ParallelFor(
+    0, nTrace, 1,
+    [&](Index const lo, Index const hi) {
+      for (Index itr = lo; itr < hi; itr++) {
+        task(itr);
+      }
+    },
+    "NDFT Forward");
   this->finishForward(y, time, false);
 }
 
@@ -130,7 +137,14 @@ template <int NDim> void NDFT<NDim>::adjoint(OutCMap const &yy, InMap &x) const
     }
     xm.chip<2>(ii) = vox * Cx(scale);
   };
-  Threads::For(task, N, "NDFT Adjoint");
+  Threads::ParallelFor(
+    0, N, 0,
+    [&](Index const lo, Index const hi) {
+      for (Index ii = lo; ii < hi; ii++) {
+        task(ii);
+      }
+    },
+    "NDFT Adjoint");
   this->finishAdjoint(x, time, false);
 }
 
@@ -0,0 +1,172 @@
+#include "nufft-normal.hpp"
+
+#include "arena.hpp"
+#include "log.hpp"
+#include "op/nufft.hpp"
+#include "threads.hpp"
+
+namespace rl::TOps {
+
+template <int NDim>
+NUFFTNormal<NDim>::NUFFTNormal(TrajectoryN<NDim> const &traj,
+                               std::string const       &ktype,
+                               float const              osamp,
+                               Index const              nC,
+                               Basis::CPtr              basis,
+                               Re2 const               &weights,
+                               Sz<NDim> const           matrix,
+                               Index const              subgridSz)
+  : Parent("NUFFTNormal")
+  , nB_{basis ? basis->nB() : 1}
+{
+  if (weights.dimension(0) != traj.nSamples() || weights.dimension(1) != traj.nTraces()) {
+    Log::Fail("NUFFTNormal weights {} did not match trajectory {}x{}", weights.dimensions(), traj.nSamples(), traj.nTraces());
+  }
+  Sz<NDim> const mat =
+    std::all_of(matrix.cbegin(), matrix.cend(), [](Index ii) { return ii < 1; }) ? traj.matrix() : matrix;
+  Sz<NDim> const mat2 = Mul(mat, 2);
+  ishape = AddFront(mat, nB_, nC);
+  oshape = ishape;
+
+  // Calculate the PSF on a 2× grid, once for each basis vector on the right of the nB × nB block
+  TrajectoryN<NDim> const newTraj(traj.points() * 2.f, Mul(traj.matrix(), 2), traj.voxelSize());
+  NUFFT<NDim, false>      nufft(newTraj, ktype, osamp, 1, basis, mat2, subgridSz);
+  Cx3                     W(nufft.oshape);
+  tf_.resize(AddFront(mat2, nB_, nB_));
+  Log::Print("NUFFTNormal Input {} Transfer function {}", ishape, tf_.dimensions());
+  Sz<NDim + 2> st;
+  st.fill(0);
+  for (Index ib = 0; ib < nB_; ib++) {
+    if (basis) {
+      Threads::For(
+        [&](Index const it) {
+          for (Index is = 0; is < W.dimension(1); is++) {
+            W(0, is, it) = weights(is, it) * basis->entry(is, it)(ib);
+          }
+        },
+        W.dimension(2));
+    } else {
+      W.chip<0>(0).device(Threads::GlobalDevice()) = weights.cast<Cx>();
+    }
+    st[1] = ib;
+    tf_.slice(st, nufft.ishape).device(Threads::GlobalDevice()) = nufft.adjoint(W);
+  }
+  Sz<NDim> fftDims;
+  std::iota(fftDims.begin(), fftDims.end(), 2);
+  FFT::Plan<NDim + 2, NDim> const tfft(tf_.dimensions(), fftDims);
+  tfft.forward(tf_);
+  tf_.device(Threads::GlobalDevice()) = tf_ * Cx(std::sqrt(static_cast<float>(Product(mat2))));
+
+  // Pad the input into the centre of the 2× grid. The circular convolution is then exact within that region.
+  InDims const gshape = AddFront(mat2, nB_, nC);
+  InDims       padRight;
+  padLeft_.fill(0);
+  padRight.fill(0);
+  for (int ii = 2; ii < InRank; ii++) {
+    padLeft_[ii] = (gshape[ii] - ishape[ii] + 1) / 2;
+    padRight[ii] = (gshape[ii] - ishape[ii]) / 2;
+  }
+  std::transform(padLeft_.cbegin(), padLeft_.cend(), padRight.cbegin(), paddings_.begin(),
+                 [](Index left, Index right) { return std::make_pair(left, right); });
+  gshape_ = gshape;
+  fft_.emplace(gshape, fftDims, LastN<NDim>(padLeft_), mat);
+  ph_ = fft_->phase().slice(LastN<NDim>(padLeft_), mat).reshape(AddFront(mat, 1, 1));
+  phBrd_.fill(1);
+  phBrd_[0] = nB_;
+  phBrd_[1] = nC;
+}
+
+template <int NDim>
+auto NUFFTNormal<NDim>::Make(TrajectoryN<NDim> const &traj,
+                             GridOpts                &opts,
+                             Index const              nC,
+                             Basis::CPtr              basis,
+                             Re2 const               &weights,
+                             Sz<NDim> const           matrix) -> std::shared_ptr<NUFFTNormal<NDim>>
+{
+  if (opts.vcc) { Log::Fail("NUFFTNormal does not support VCC"); }
+  return std::make_shared<NUFFTNormal<NDim>>(traj, opts.ktype.Get(), opts.osamp.Get(), nC, basis, weights, matrix,
+                                             opts.subgridSize.Get());
+}
+
+template <int NDim> void NUFFTNormal<NDim>::convolve(InMap &ws) const
+{
+  if (nB_ == 1) {
+    Sz<NDim + 2> brd;
+    brd.fill(1);
+    brd[1] = ws.dimension(1);
+    ws.device(Threads::GlobalDevice()) = ws * tf_.broadcast(brd);
+  } else {
+    Index const nC = ws.dimension(1);
+    Index const nB2 = nB_ * nB_;
+    Threads::ParallelFor(0, Product(LastN<NDim>(ws.dimensions())), 0, [&](Index const lo, Index const hi) {
+      Eigen::VectorXcf temp(nB_);
+      for (Index iv = lo; iv < hi; iv++) {
+        Eigen::Map<Eigen::MatrixXcf const> T(tf_.data() + iv * nB2, nB_, nB_);
+        for (Index ic = 0; ic < nC; ic++) {
+          Eigen::Map<Eigen::VectorXcf> w(ws.data() + (iv * nC + ic) * nB_, nB_);
+          temp.noalias() = T * w;
+          w = temp;
+        }
+      }
+    });
+  }
+}
+
+template <int NDim> void NUFFTNormal<NDim>::forward(InCMap const &x, OutMap &y) const
+{
+  auto const time = this->startForward(x, y, false);
+  Arena::Lease ws(Product(gshape_) * sizeof(Cx));
+  InMap        wsm(ws.data<Cx>(), gshape_);
+  wsm.device(Threads::GlobalDevice()) = (x * ph_.broadcast(phBrd_)).pad(paddings_);
+  fft_->forwardPruned(wsm);
+  convolve(wsm);
+  fft_->adjointPruned(wsm);
+  y.device(Threads::GlobalDevice()) = wsm.slice(padLeft_, ishape) * ph_.conjugate().broadcast(phBrd_);
+  this->finishForward(y, time, false);
+}
+
+template <int NDim> void NUFFTNormal<NDim>::adjoint(OutCMap const &y, InMap &x) const
+{
+  auto const time = this->startAdjoint(y, x, false);
+  Arena::Lease ws(Product(gshape_) * sizeof(Cx));
+  InMap        wsm(ws.data<Cx>(), gshape_);
+  wsm.device(Threads::GlobalDevice()) = (y * ph_.broadcast(phBrd_)).pad(paddings_);
+  fft_->forwardPruned(wsm);
+  convolve(wsm);
+  fft_->adjointPruned(wsm);
+  x.device(Threads::GlobalDevice()) = wsm.slice(padLeft_, ishape) * ph_.conjugate().broadcast(phBrd_);
+  this->finishAdjoint(x, time, false);
+}
+
+template <int NDim> void NUFFTNormal<NDim>::iforward(InCMap const &x, OutMap &y) const
+{
+  auto const time = this->startForward(x, y, true);
+  Arena::Lease ws(Product(gshape_) * sizeof(Cx));
+  InMap        wsm(ws.data<Cx>(), gshape_);
+  wsm.device(Threads::GlobalDevice()) = (x * ph_.broadcast(phBrd_)).pad(paddings_);
+  fft_->forwardPruned(wsm);
+  convolve(wsm);
+  fft_->adjointPruned(wsm);
+  y.device(Threads::GlobalDevice()) += wsm.slice(padLeft_, ishape) * ph_.conjugate().broadcast(phBrd_);
+  this->finishForward(y, time, true);
+}
+
+template <int NDim> void NUFFTNormal<NDim>::iadjoint(OutCMap const &y, InMap &x) const
+{
+  auto const time = this->startAdjoint(y, x, true);
+  Arena::Lease ws(Product(gshape_) * sizeof(Cx));
+  InMap        wsm(ws.data<Cx>(), gshape_);
+  wsm.device(Threads::GlobalDevice()) = (y * ph_.broadcast(phBrd_)).pad(paddings_);
+  fft_->forwardPruned(wsm);
+  convolve(wsm);
+  fft_->adjointPruned(wsm);
+  x.device(Threads::GlobalDevice()) += wsm.slice(padLeft_, ishape) * ph_.conjugate().broadcast(phBrd_);
+  this->finishAdjoint(x, time, true);
+}
+
+template struct NUFFTNormal<1>;
+template struct NUFFTNormal<2>;
+template struct NUFFTNormal<3>;
+
+} // namespace rl::TOps
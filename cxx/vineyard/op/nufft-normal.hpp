@@ -0,0 +1,57 @@
+#pragma once
+
+#include "op/top.hpp"
+
+#include "op/grid.hpp"
+
+#include "../fft.hpp"
+
+#include <optional>
+
+namespace rl::TOps {
+
+/*
+ * The normal operator A'WA of a (non-VCC) NUFFT with k-space weights W, applied as a convolution with the point-spread
+ * function. The PSF is calculated once with a NUFFT on a 2× grid, after which each application is an FFT, a multiply by
+ * the transfer function and an IFFT, so the cost no longer depends on the number of samples. With a basis the transfer
+ * function is an nB × nB matrix at each grid point.
+ */
+template <int NDim> struct NUFFTNormal final : TOp<Cx, NDim + 2, NDim + 2>
+{
+  TOP_INHERIT(Cx, NDim + 2, NDim + 2)
+  NUFFTNormal(TrajectoryN<NDim> const &traj,
+              std::string const       &ktype,
+              float const              osamp,
+              Index const              nC,
+              Basis::CPtr              basis,
+              Re2 const               &weights,
+              Sz<NDim> const           matrix = Sz<NDim>(),
+              Index const              subgridSz = 32);
+  TOP_DECLARE(NUFFTNormal)
+
+  static auto Make(TrajectoryN<NDim> const &traj,
+                   GridOpts                &opts,
+                   Index const              nC,
+                   Basis::CPtr              basis,
+                   Re2 const               &weights,
+                   Sz<NDim> const           matrix = Sz<NDim>()) -> std::shared_ptr<NUFFTNormal<NDim>>;
+
+  void iforward(InCMap const &x, OutMap &y) const;
+  void iadjoint(OutCMap const &y, InMap &x) const;
+
+private:
+  void convolve(InMap &ws) const;
+
+  Index  nB_;
+  InDims gshape_; // Padded 2× grid
+
+  std::optional<FFT::Plan<NDim + 2, NDim>> fft_;
+
+  CxN<NDim + 2> tf_; // Transfer function nB × nB × grid
+  InTensor      ph_; // FFT-shift phase of the un-padded region
+  InDims        phBrd_, padLeft_;
+
+  std::array<std::pair<Index, Index>, NDim + 2> paddings_;
+};
+
+} // namespace rl::TOps
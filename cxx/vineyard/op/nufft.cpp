@@ -1,7 +1,7 @@
 #include "nufft.hpp"
 
-#include "../fft.hpp"
 #include "apodize.hpp"
+#include "arena.hpp"
 #include "log.hpp"
 
 namespace rl::TOps {
@@ -14,10 +14,10 @@ NUFFT<NDim, VCC>::NUFFT(TrajectoryN<NDim> const &traj,
                         Basis::CPtr              basis,
                         Sz<NDim> const           matrix,
                         Index const              subgridSz,
-                        Index const              nBatch)
+                        Index const              nBatch,
+                        Index const              kTableMB)
   : Parent("NUFFT")
-  , gridder{traj, ktype, osamp, nChan / nBatch, basis, subgridSz}
-  , workspace{gridder.ishape}
+  , gridder{traj, ktype, osamp, nChan / nBatch, basis, subgridSz, kTableMB}
   , batches{nBatch}
 {
   if (nChan % nBatch != 0) { Log::Fail("Batch size {} does not cleanly divide number of channels {}", nBatch, nChan); }
@@ -39,18 +39,8 @@ NUFFT<NDim, VCC>::NUFFT(TrajectoryN<NDim> const &traj,
   ishape[1] = nChan; // Undo batching
   oshape = gridder.oshape;
   oshape[0] = nChan;
-  std::iota(fftDims.begin(), fftDims.end(), 2 + VCC);
-  fftPh = FFT::PhaseShift(LastN<NDim>(gridder.ishape));
   Log::Print("NUFFT Input {} Output {} Grid {} Batches {}", ishape, oshape, gridder.ishape, batches);
 
-  // Calculate apodization correction
-  auto apo_shape = ishape;
-  apoBrd_.fill(1);
-  for (int ii = 0; ii < 2 + VCC; ii++) {
-    apo_shape[ii] = 1;
-    apoBrd_[ii] = gridder.ishape[ii];
-  }
-  apo_ = Apodize(LastN<NDim>(ishape), LastN<NDim>(gridder.ishape), gridder.kernel).reshape(apo_shape);\
   // Padding stuff
   Sz<InRank> padRight;
   padLeft_.fill(0);
@@ -61,6 +51,20 @@ NUFFT<NDim, VCC>::NUFFT(TrajectoryN<NDim> const &traj,
   }
   std::transform(padLeft_.cbegin(), padLeft_.cend(), padRight.cbegin(), paddings_.begin(),
                  [](Index left, Index right) { return std::make_pair(left, right); });
+  Sz<NDim> fftDims;
+  std::iota(fftDims.begin(), fftDims.end(), 2 + VCC);
+  fft_.emplace(gridder.ishape, fftDims, LastN<NDim>(padLeft_), LastN<NDim>(ishape));
+
+  // Calculate apodization correction. The FFT phase ramp on the image side only needs applying within the un-padded
+  // region, so fold it in here and use the pruned FFTs.
+  auto apo_shape = ishape;
+  apoBrd_.fill(1);
+  for (int ii = 0; ii < 2 + VCC; ii++) {
+    apo_shape[ii] = 1;
+    apoBrd_[ii] = gridder.ishape[ii];
+  }
+  CxN<NDim> const apo = Apodize(LastN<NDim>(ishape), LastN<NDim>(gridder.ishape), gridder.kernel);
+  apo_ = (apo * fft_->phase().slice(LastN<NDim>(padLeft_), LastN<NDim>(ishape))).reshape(apo_shape);
 }
 
 template <int NDim, bool VCC>
@@ -69,31 +73,80 @@ auto NUFFT<NDim, VCC>::Make(
   -> std::shared_ptr<NUFFT<NDim, VCC>>
 {
   return std::make_shared<NUFFT<NDim, VCC>>(traj, opts.ktype.Get(), opts.osamp.Get(), nC, basis, matrix, opts.subgridSize.Get(),
-                                            opts.batches.Get());
+                                            opts.batches.Get(), opts.kTable.Get());
+}
+
+/*
+ * With channel batches the pad+FFT of batch k + 1 runs alongside the gridding of batch k (and for the adjoint the IFFT
+ * of batch k alongside the gridding of batch k + 1), each using its own workspace. The FFT stage runs on a helper thread
+ * via Threads::Async, and both stages schedule onto the pool, so one fills the gaps left by the other, e.g. the barriers
+ * between colours in the adjoint. The gridder reads and writes the batch's channels of y directly.
+ */
+template <int NDim, bool VCC> void NUFFT<NDim, VCC>::forwardBatches(InCMap const &x, OutMap &y) const
+{
+  Index const  wsSz = Product(gridder.ishape);
+  Arena::Lease ws(2 * wsSz * sizeof(Cx));
+  auto const   fill = [&](Index const ib) {
+    InMap              wsm(ws.data<Cx>() + (ib % 2) * wsSz, gridder.ishape);
+    Sz<NDim + 2 + VCC> x_start;
+    x_start.fill(0);
+    x_start[1] = ib * gridder.ishape[1];
+    wsm.device(Threads::GlobalDevice()) = (x.slice(x_start, batchShape_) * apo_.broadcast(apoBrd_)).pad(paddings_);
+    fft_->forwardPruned(wsm);
+  };
+  fill(0);
+  for (Index ib = 0; ib < batches; ib++) {
+    std::future<void> next;
+    if (ib + 1 < batches) { next = Threads::Async([&, ib] { fill(ib + 1); }); }
+    InCMap wscm(ws.data<Cx>() + (ib % 2) * wsSz, gridder.ishape);
+    gridder.iforwardBatch(wscm, y, ib * gridder.oshape[0]);
+    if (next.valid()) { next.get(); }
+  }
+}
+
+template <int NDim, bool VCC> void NUFFT<NDim, VCC>::adjointBatches(OutCMap const &y, InMap &x, bool const accumulate) const
+{
+  Index const  wsSz = Product(gridder.ishape);
+  Arena::Lease ws(2 * wsSz * sizeof(Cx));
+  auto const   grid = [&](Index const ib) {
+    InMap wsm(ws.data<Cx>() + (ib % 2) * wsSz, gridder.ishape);
+    gridder.adjointBatch(y, wsm, ib * gridder.oshape[0]);
+  };
+  auto const finish = [&](Index const ib) {
+    InMap              wsm(ws.data<Cx>() + (ib % 2) * wsSz, gridder.ishape);
+    Sz<NDim + 2 + VCC> x_start;
+    x_start.fill(0);
+    x_start[1] = ib * gridder.ishape[1];
+    fft_->adjointPruned(wsm);
+    if (accumulate) {
+      x.slice(x_start, batchShape_).device(Threads::GlobalDevice()) +=
+        wsm.slice(padLeft_, batchShape_) * apo_.conjugate().broadcast(apoBrd_);
+    } else {
+      x.slice(x_start, batchShape_).device(Threads::GlobalDevice()) =
+        wsm.slice(padLeft_, batchShape_) * apo_.conjugate().broadcast(apoBrd_);
+    }
+  };
+  grid(0);
+  for (Index ib = 0; ib < batches; ib++) {
+    auto done = Threads::Async([&, ib] { finish(ib); });
+    if (ib + 1 < batches) { grid(ib + 1); }
+    done.get();
+  }
 }
 
 template <int NDim, bool VCC> void NUFFT<NDim, VCC>::forward(InCMap const &x, OutMap &y) const
 {
   auto const time = this->startForward(x, y, false);
-  InMap      wsm(workspace.data(), gridder.ishape);
   if (batches == 1) {
+    Arena::Lease ws(Product(gridder.ishape) * sizeof(Cx));
+    InMap        wsm(ws.data<Cx>(), gridder.ishape);
+    InCMap       wscm(ws.data<Cx>(), gridder.ishape);
     wsm.device(Threads::GlobalDevice()) = (x * apo_.broadcast(apoBrd_)).pad(paddings_);
-    FFT::Forward(workspace, fftDims, fftPh);
-    gridder.forward(workspace, y);
+    fft_->forwardPruned(wsm);
+    gridder.forward(wscm, y);
   } else {
-    OutTensor    yt(gridder.oshape);
-    OutMap       ytm(yt.data(), yt.dimensions());
-    Sz<NDim + 3> x_start;
-    Sz3          y_start;
-    for (Index ib = 0; ib < batches; ib++) {
-      Index const ic = ib * gridder.ishape[1];
-      x_start[1] = ic;
-      y_start[0] = ic;
-      wsm.device(Threads::GlobalDevice()) = (x.slice(x_start, batchShape_) * apo_.broadcast(apoBrd_)).pad(paddings_);
-      FFT::Forward(workspace, fftDims, fftPh);
-      gridder.forward(workspace, ytm);
-      y.slice(y_start, yt.dimensions()).device(Threads::GlobalDevice()) = yt;
-    }
+    y.device(Threads::GlobalDevice()) = y.constant(0.f);
+    forwardBatches(x, y);
   }
   this->finishForward(y, time, false);
 }
@@ -101,25 +154,14 @@ template <int NDim, bool VCC> void NUFFT<NDim, VCC>::forward(InCMap const &x, Ou
 template <int NDim, bool VCC> void NUFFT<NDim, VCC>::adjoint(OutCMap const &y, InMap &x) const
 {
   auto const time = this->startAdjoint(y, x, false);
-  InMap      wsm(workspace.data(), gridder.ishape);
   if (batches == 1) {
+    Arena::Lease ws(Product(gridder.ishape) * sizeof(Cx));
+    InMap        wsm(ws.data<Cx>(), gridder.ishape);
     gridder.adjoint(y, wsm);
-    FFT::Adjoint(workspace, fftDims, fftPh);
-    x.device(Threads::GlobalDevice()) = workspace.slice(padLeft_, batchShape_) * apo_.broadcast(apoBrd_);
+    fft_->adjointPruned(wsm);
+    x.device(Threads::GlobalDevice()) = wsm.slice(padLeft_, batchShape_) * apo_.conjugate().broadcast(apoBrd_);
   } else {
-    OutTensor    yt(gridder.oshape);
-    Sz<NDim + 3> x_start;
-    Sz3          y_start;
-    for (Index ib = 0; ib < batches; ib++) {
-      Index const ic = ib * gridder.ishape[1];
-      x_start[1] = ic;
-      y_start[0] = ic;
-      yt.device(Threads::GlobalDevice()) = y.slice(y_start, yt.dimensions());
-      gridder.adjoint(yt, wsm);
-      FFT::Adjoint(workspace, fftDims, fftPh);
-      x.slice(x_start, batchShape_).device(Threads::GlobalDevice()) =
-        workspace.slice(padLeft_, batchShape_) * apo_.broadcast(apoBrd_);
-    }
+    adjointBatches(y, x, false);
   }
   this->finishAdjoint(x, time, false);
 }
@@ -127,25 +169,15 @@ template <int NDim, bool VCC> void NUFFT<NDim, VCC>::adjoint(OutCMap const &y, I
 template <int NDim, bool VCC> void NUFFT<NDim, VCC>::iforward(InCMap const &x, OutMap &y) const
 {
   auto const time = this->startForward(x, y, true);
-  InMap      wsm(workspace.data(), gridder.ishape);
   if (batches == 1) {
+    Arena::Lease ws(Product(gridder.ishape) * sizeof(Cx));
+    InMap        wsm(ws.data<Cx>(), gridder.ishape);
+    InCMap       wscm(ws.data<Cx>(), gridder.ishape);
     wsm.device(Threads::GlobalDevice()) = (x * apo_.broadcast(apoBrd_)).pad(paddings_);
-    FFT::Forward(workspace, fftDims, fftPh);
-    gridder.iforward(workspace, y);
+    fft_->forwardPruned(wsm);
+    gridder.iforward(wscm, y);
   } else {
-    OutTensor    yt(gridder.oshape);
-    OutMap       ytm(yt.data(), yt.dimensions());
-    Sz<NDim + 3> x_start;
-    Sz3          y_start;
-    for (Index ib = 0; ib < batches; ib++) {
-      Index const ic = ib * gridder.ishape[1];
-      x_start[1] = ic;
-      y_start[0] = ic;
-      wsm.device(Threads::GlobalDevice()) = (x.slice(x_start, batchShape_) * apo_.broadcast(apoBrd_)).pad(paddings_);
-      FFT::Forward(workspace, fftDims, fftPh);
-      gridder.forward(workspace, ytm);
-      y.slice(y_start, yt.dimensions()).device(Threads::GlobalDevice()) += yt;
-    }
+    forwardBatches(x, y);
   }
   this->finishForward(y, time, true);
 }
@@ -153,25 +185,14 @@ template <int NDim, bool VCC> void NUFFT<NDim, VCC>::iforward(InCMap const &x, O
 template <int NDim, bool VCC> void NUFFT<NDim, VCC>::iadjoint(OutCMap const &y, InMap &x) const
 {
   auto const time = this->startAdjoint(y, x, true);
-  InMap      wsm(workspace.data(), gridder.ishape);
   if (batches == 1) {
+    Arena::Lease ws(Product(gridder.ishape) * sizeof(Cx));
+    InMap        wsm(ws.data<Cx>(), gridder.ishape);
     gridder.adjoint(y, wsm);
-    FFT::Adjoint(workspace, fftDims, fftPh);
-    x.device(Threads::GlobalDevice()) += workspace.slice(padLeft_, batchShape_) * apo_.broadcast(apoBrd_);
+    fft_->adjointPruned(wsm);
+    x.device(Threads::GlobalDevice()) += wsm.slice(padLeft_, batchShape_) * apo_.conjugate().broadcast(apoBrd_);
   } else {
-    OutTensor    yt(gridder.oshape);
-    Sz<NDim + 3> x_start;
-    Sz3          y_start;
-    for (Index ib = 0; ib < batches; ib++) {
-      Index const ic = ib * gridder.ishape[1];
-      x_start[1] = ic;
-      y_start[0] = ic;
-      yt.device(Threads::GlobalDevice()) = y.slice(y_start, yt.dimensions());
-      gridder.adjoint(yt, wsm);
-      FFT::Adjoint(workspace, fftDims, fftPh);
-      x.slice(x_start, batchShape_).device(Threads::GlobalDevice()) +=
-        workspace.slice(padLeft_, batchShape_) * apo_.broadcast(apoBrd_);
-    }
+    adjointBatches(y, x, true);
   }
   this->finishAdjoint(x, time, true);
 }
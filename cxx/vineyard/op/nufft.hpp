@@ -5,6 +5,10 @@
 #include "op/grid.hpp"
 #include "op/pad.hpp"
 
+#include "../fft.hpp"
+
+#include <optional>
+
 namespace rl::TOps {
 
 template <int NDim, bool VCC = false> struct NUFFT final : TOp<Cx, NDim + 2 + VCC, 3>
@@ -17,7 +21,8 @@ template <int NDim, bool VCC = false> struct NUFFT final : TOp<Cx, NDim + 2 + VC
         Basis::CPtr              basis,
         Sz<NDim> const           matrix = Sz<NDim>(),
         Index const              subgridSz = 32,
-        Index const              nBatches = 1);
+        Index const              nBatches = 1,
+        Index const              kTableMB = 0);
   TOP_DECLARE(NUFFT)
 
   static auto
@@ -28,15 +33,17 @@ template <int NDim, bool VCC = false> struct NUFFT final : TOp<Cx, NDim + 2 + VC
   void iforward(InCMap const &x, OutMap &y) const;
 
 private:
+  void forwardBatches(InCMap const &x, OutMap &y) const;
+  void adjointBatches(OutCMap const &y, InMap &x, bool const accumulate) const;
+
   Grid<NDim, VCC> gridder;
-  InTensor mutable workspace;
 
   Index const batches;
   InDims      batchShape_;
-  Sz<NDim>    fftDims;
-  CxN<NDim>   fftPh;
 
-  InTensor apo_;
+  std::optional<FFT::Plan<NDim + 2 + VCC, NDim>> fft_;
+
+  InTensor apo_; // Apodization with the FFT-shift phase of the padded region folded in
   InDims   apoBrd_, padLeft_;
 
   std::array<std::pair<Index, Index>, NDim + 2 + VCC> paddings_;
@@ -1,5 +1,6 @@
 #include "ops.hpp"
 
+#include "arena.hpp"
 #include "log.hpp"
 #include "threads.hpp"
 
@@ -263,9 +264,9 @@ template <typename S> auto Multiply<S>::cols() const -> Index { return B->cols()
 template <typename S> void Multiply<S>::forward(CMap const &x, Map &y) const
 {
   auto const time = this->startForward(x, y, false);
-  Vector     temp(B->rows());
-  Map        tm(temp.data(), temp.size());
-  CMap       tcm(temp.data(), temp.size());
+  Arena::Lease temp(B->rows() * sizeof(S));
+  Map          tm(temp.data<S>(), B->rows());
+  CMap         tcm(temp.data<S>(), B->rows());
   B->forward(x, tm);
   A->forward(tcm, y);
   this->finishForward(y, time, false);
@@ -274,9 +275,9 @@ template <typename S> void Multiply<S>::forward(CMap const &x, Map &y) const
 template <typename S> void Multiply<S>::adjoint(CMap const &y, Map &x) const
 {
   auto const time = this->startAdjoint(y, x, false);
-  Vector     temp(A->cols());
-  Map        tm(temp.data(), temp.size());
-  CMap       tcm(temp.data(), temp.size());
+  Arena::Lease temp(A->cols() * sizeof(S));
+  Map          tm(temp.data<S>(), A->cols());
+  CMap         tcm(temp.data<S>(), A->cols());
   A->adjoint(y, tm);
   B->adjoint(tcm, x);
   this->finishAdjoint(x, time, false);
@@ -285,9 +286,9 @@ template <typename S> void Multiply<S>::adjoint(CMap const &y, Map &x) const
 template <typename S> void Multiply<S>::iforward(CMap const &x, Map &y) const
 {
   auto const time = this->startForward(x, y, true);
-  Vector     temp(B->rows());
-  Map        tm(temp.data(), temp.size());
-  CMap       tcm(temp.data(), temp.size());
+  Arena::Lease temp(B->rows() * sizeof(S));
+  Map          tm(temp.data<S>(), B->rows());
+  CMap         tcm(temp.data<S>(), B->rows());
   B->forward(x, tm);
   A->iforward(tcm, y);
   this->finishForward(y, time, true);
@@ -296,9 +297,9 @@ template <typename S> void Multiply<S>::iforward(CMap const &x, Map &y) const
 template <typename S> void Multiply<S>::iadjoint(CMap const &y, Map &x) const
 {
   auto const time = this->startAdjoint(y, x, true);
-  Vector     temp(A->cols());
-  Map        tm(temp.data(), temp.size());
-  CMap       tcm(temp.data(), temp.size());
+  Arena::Lease temp(A->cols() * sizeof(S));
+  Map          tm(temp.data<S>(), A->cols());
+  CMap         tcm(temp.data<S>(), A->cols());
   A->adjoint(y, tm);
   B->iadjoint(tcm, x);
   this->finishAdjoint(x, time, true);
@@ -658,6 +659,55 @@ template <typename S> void Extract<S>::iadjoint(CMap const &y, Map &x) const
 template struct Extract<float>;
 template struct Extract<Cx>;
 
+template <typename S>
+Add<S>::Add(std::shared_ptr<Op<S>> aa, std::shared_ptr<Op<S>> bb)
+  : Op<S>("Add")
+  , a{aa}
+  , b{bb}
+{
+  if (a->rows() != b->rows() || a->cols() != b->cols()) {
+    Log::Fail("Add Op mismatched dimensions [{},{}] and [{},{}]", a->rows(), a->cols(), b->rows(), b->cols());
+  }
+}
+
+template <typename S> auto Add<S>::rows() const -> Index { return a->rows(); }
+template <typename S> auto Add<S>::cols() const -> Index { return a->cols(); }
+
+template <typename S> void Add<S>::forward(CMap const &x, Map &y) const
+{
+  auto const time = this->startForward(x, y, false);
+  a->forward(x, y);
+  b->iforward(x, y);
+  this->finishForward(y, time, false);
+}
+
+template <typename S> void Add<S>::adjoint(CMap const &y, Map &x) const
+{
+  auto const time = this->startAdjoint(y, x, false);
+  a->adjoint(y, x);
+  b->iadjoint(y, x);
+  this->finishAdjoint(x, time, false);
+}
+
+template <typename S> void Add<S>::iforward(CMap const &x, Map &y) const
+{
+  auto const time = this->startForward(x, y, true);
+  a->iforward(x, y);
+  b->iforward(x, y);
+  this->finishForward(y, time, true);
+}
+
+template <typename S> void Add<S>::iadjoint(CMap const &y, Map &x) const
+{
+  auto const time = this->startAdjoint(y, x, true);
+  a->iadjoint(y, x);
+  b->iadjoint(y, x);
+  this->finishAdjoint(x, time, true);
+}
+
+template struct Add<float>;
+template struct Add<Cx>;
+
 template <typename S>
 Subtract<S>::Subtract(std::shared_ptr<Op<S>> aa, std::shared_ptr<Op<S>> bb)
   : Op<S>("Subtract")
@@ -675,8 +725,8 @@ template <typename S> void Subtract<S>::forward(CMap const &x, Map &y) const
 {
   auto const time = this->startForward(x, y, false);
   a->forward(x, y);
-  Vector temp(rows());
-  Map    tm(temp.data(), temp.rows());
+  Arena::Lease temp(rows() * sizeof(S));
+  Map          tm(temp.data<S>(), rows());
   b->forward(x, tm);
   y -= tm;
   this->finishForward(y, time, false);
@@ -686,8 +736,8 @@ template <typename S> void Subtract<S>::adjoint(CMap const &y, Map &x) const
 {
   auto const time = this->startAdjoint(y, x, false);
   a->adjoint(y, x);
-  Vector temp(cols());
-  Map    tm(temp.data(), temp.rows());
+  Arena::Lease temp(cols() * sizeof(S));
+  Map          tm(temp.data<S>(), cols());
   b->adjoint(y, tm);
   x -= tm;
   this->finishAdjoint(x, time, false);
@@ -697,8 +747,8 @@ template <typename S> void Subtract<S>::iforward(CMap const &x, Map &y) const
 {
   auto const time = this->startForward(x, y, true);
   a->iforward(x, y);
-  Vector temp(rows());
-  Map    tm(temp.data(), temp.rows());
+  Arena::Lease temp(rows() * sizeof(S));
+  Map          tm(temp.data<S>(), rows());
   b->forward(x, tm);
   y -= tm;
   this->finishForward(y, time, true);
@@ -708,8 +758,8 @@ template <typename S> void Subtract<S>::iadjoint(CMap const &y, Map &x) const
 {
   auto const time = this->startAdjoint(y, x, true);
   a->iadjoint(y, x);
-  Vector temp(cols());
-  Map    tm(temp.data(), temp.rows());
+  Arena::Lease temp(cols() * sizeof(S));
+  Map          tm(temp.data<S>(), cols());
   b->adjoint(y, tm);
   x -= tm;
   this->finishAdjoint(x, time, true);
@@ -137,6 +137,18 @@ private:
   Index r, c, start;
 };
 
+template <typename Scalar = Cx> struct Add final : Op<Scalar>
+{
+  OP_INHERIT
+  Add(std::shared_ptr<Op<Scalar>> a, std::shared_ptr<Op<Scalar>> b);
+  void forward(CMap const &x, Map &y) const;
+  void adjoint(CMap const &y, Map &x) const;
+  void iforward(CMap const &x, Map &y) const;
+  void iadjoint(CMap const &y, Map &x) const;
+private:
+  std::shared_ptr<Op<Scalar>> a, b;
+};
+
 template <typename Scalar = Cx> struct Subtract final : Op<Scalar>
 {
   OP_INHERIT
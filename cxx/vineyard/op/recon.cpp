@@ -5,8 +5,10 @@
 #include "op/multiplex.hpp"
 #include "op/ndft.hpp"
 #include "op/nufft.hpp"
+#include "op/nufft-normal.hpp"
 #include "op/reshape.hpp"
 #include "op/sense.hpp"
+#include "op/sense-nufft.hpp"
 
 namespace rl {
 namespace Recon {
@@ -19,10 +21,21 @@ auto SENSE(bool const        ndft,
            Index const       nTime,
            Basis::CPtr       b,
            Cx5 const        &data) -> TOps::TOp<Cx, 5, 5>::Ptr
+{
+  return SENSE(ndft, gridOpts, SENSE::Choose(senseOpts, gridOpts, traj, data), traj, nSlab, nTime, b);
+}
+
+auto SENSE(bool const        ndft,
+           GridOpts         &gridOpts,
+           Cx5 const        &maps,
+           Trajectory const &traj,
+           Index const       nSlab,
+           Index const       nTime,
+           Basis::CPtr       b) -> TOps::TOp<Cx, 5, 5>::Ptr
 {
   if (ndft) {
     if (gridOpts.vcc) { Log::Warn("VCC and NDFT not supported yet"); }
-    auto sense = std::make_shared<TOps::SENSE>(SENSE::Choose(senseOpts, gridOpts, traj, data), b ? b->nB() : 1);
+    auto sense = std::make_shared<TOps::SENSE>(maps, b ? b->nB() : 1, ParsePrecision(gridOpts.precision.Get()));
     auto nufft = TOps::NDFT<3>::Make(sense->mapDimensions(), traj.points(), sense->nChannels(), b);
     auto loop = TOps::MakeLoop(nufft, nSlab);
     auto slabToVol = std::make_shared<TOps::Multiplex<Cx, 5>>(sense->oshape, nSlab);
@@ -32,7 +45,10 @@ auto SENSE(bool const        ndft,
     return timeLoop;
   } else {
     if (gridOpts.vcc) {
-      auto sense = std::make_shared<TOps::VCCSENSE>(SENSE::Choose(senseOpts, gridOpts, traj, data), b ? b->nB() : 1);
+      if (ParsePrecision(gridOpts.precision.Get()) != Precision::Single) {
+        Log::Warn("Reduced precision SENSE maps not supported with VCC yet, using float");
+      }
+      auto sense = std::make_shared<TOps::VCCSENSE>(maps, b ? b->nB() : 1);
       auto nufft = TOps::NUFFT<3, true>::Make(traj, gridOpts, sense->nChannels(), b, sense->mapDimensions());
       auto loop = TOps::MakeLoop(nufft, nSlab);
       auto slabToVol = std::make_shared<TOps::Multiplex<Cx, 6>>(sense->oshape, nSlab);
@@ -40,8 +56,13 @@ auto SENSE(bool const        ndft,
       auto compose2 = TOps::MakeCompose(sense, compose1);
       auto timeLoop = TOps::MakeLoop(compose2, nTime);
       return timeLoop;
+    } else if (nSlab == 1) {
+      auto sn = TOps::SENSENUFFT::Make(traj, gridOpts, maps, b);
+      auto reshape = std::make_shared<TOps::ReshapeOutput<TOps::SENSENUFFT, 4>>(sn, AddBack(sn->oshape, 1));
+      auto timeLoop = TOps::MakeLoop(reshape, nTime);
+      return timeLoop;
     } else {
-      auto sense = std::make_shared<TOps::SENSE>(SENSE::Choose(senseOpts, gridOpts, traj, data), b ? b->nB() : 1);
+      auto sense = std::make_shared<TOps::SENSE>(maps, b ? b->nB() : 1, ParsePrecision(gridOpts.precision.Get()));
       auto nufft = TOps::NUFFT<3, false>::Make(traj, gridOpts, sense->nChannels(), b, sense->mapDimensions());
       auto slabLoop = TOps::MakeLoop(nufft, nSlab);
       auto slabToVol = std::make_shared<TOps::Multiplex<Cx, 5>>(sense->oshape, nSlab);
@@ -53,6 +74,22 @@ auto SENSE(bool const        ndft,
   }
 }
 
+auto SENSENormal(GridOpts         &gridOpts,
+                 Cx5 const        &maps,
+                 Trajectory const &traj,
+                 Index const       nSlab,
+                 Index const       nTime,
+                 Basis::CPtr       b,
+                 Re2 const        &weights) -> TOps::TOp<Cx, 5, 5>::Ptr
+{
+  if (nSlab > 1) { Log::Fail("Toeplitz normal operator does not support multiple slabs yet"); }
+  auto sense = std::make_shared<TOps::SENSE>(maps, b ? b->nB() : 1, ParsePrecision(gridOpts.precision.Get()));
+  auto normal = TOps::NUFFTNormal<3>::Make(traj, gridOpts, sense->nChannels(), b, weights, sense->mapDimensions());
+  auto sandwich = TOps::MakeSandwich(sense, normal);
+  auto timeLoop = TOps::MakeLoop(sandwich, nTime);
+  return timeLoop;
+}
+
 auto Channels(bool const        ndft,
               GridOpts         &gridOpts,
               Trajectory const &traj,
@@ -22,6 +22,25 @@ auto SENSE(bool const        ndft,
            Basis::CPtr       basis,
            Cx5 const        &data) -> TOps::TOp<Cx, 5, 5>::Ptr;
 
+auto SENSE(bool const        ndft,
+           GridOpts         &gridOpts,
+           Cx5 const        &maps,
+           Trajectory const &traj,
+           Index const       nSlab,
+           Index const       nTime,
+           Basis::CPtr       basis) -> TOps::TOp<Cx, 5, 5>::Ptr;
+
+/*
+ *  A'WA for the SENSE recon with k-space weights W, using the Toeplitz embedding of the NUFFT
+ */
+auto SENSENormal(GridOpts         &gridOpts,
+                 Cx5 const        &maps,
+                 Trajectory const &traj,
+                 Index const       nSlab,
+                 Index const       nTime,
+                 Basis::CPtr       basis,
+                 Re2 const        &weights) -> TOps::TOp<Cx, 5, 5>::Ptr;
+
 auto Channels(bool const        ndft,
               GridOpts         &gridOpts,
               Trajectory const &traj,
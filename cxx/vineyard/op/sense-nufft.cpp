@@ -0,0 +1,143 @@
+#include "sense-nufft.hpp"
+
+#include "apodize.hpp"
+#include "arena.hpp"
+#include "log.hpp"
+#include "tensors.hpp"
+#include "threads.hpp"
+
+namespace rl::TOps {
+
+SENSENUFFT::SENSENUFFT(Trajectory const  &traj,
+                       std::string const &ktype,
+                       float const        osamp,
+                       Cx5 const         &maps,
+                       Basis::CPtr        basis,
+                       Index const        subgridSz,
+                       Index const        nBatch,
+                       Index const        kTableMB,
+                       Precision const    precision)
+  : Parent("SENSENUFFT")
+  , gridder{traj, ktype, osamp, maps.dimension(1) / nBatch, basis, subgridSz, kTableMB}
+  , batches{nBatch}
+{
+  Index const nB = basis ? basis->nB() : 1;
+  Index const nC = maps.dimension(1);
+  Sz3 const   mat = LastN<3>(maps.dimensions());
+  if (nC % nBatch != 0) { Log::Fail("Batch size {} does not cleanly divide number of channels {}", nBatch, nC); }
+  if (maps.dimension(0) != 1 && maps.dimension(0) != nB) {
+    Log::Fail("SENSE maps had basis size {}, expected {}", maps.dimension(0), nB);
+  }
+  if (!std::equal(mat.cbegin(), mat.cend(), gridder.ishape.cbegin() + 2, std::less_equal())) {
+    Log::Fail("SENSE maps {} are larger than the grid {}", mat, LastN<3>(gridder.ishape));
+  }
+  ishape = AddFront(mat, nB);
+  oshape = gridder.oshape;
+  oshape[0] = nC;
+  batchShape_ = AddFront(mat, nB, gridder.ishape[1]);
+  Log::Print("SENSENUFFT Input {} Output {} Grid {} Batches {}", ishape, oshape, gridder.ishape, batches);
+
+  Sz5 padRight;
+  padLeft_.fill(0);
+  padRight.fill(0);
+  for (int ii = 2; ii < 5; ii++) {
+    padLeft_[ii] = (gridder.ishape[ii] - batchShape_[ii] + 1) / 2;
+    padRight[ii] = (gridder.ishape[ii] - batchShape_[ii]) / 2;
+  }
+  std::transform(padLeft_.cbegin(), padLeft_.cend(), padRight.cbegin(), paddings_.begin(),
+                 [](Index left, Index right) { return std::make_pair(left, right); });
+  fft_.emplace(gridder.ishape, Sz3{2, 3, 4}, LastN<3>(padLeft_), mat);
+
+  // Fold the apodization and the FFT phase ramp of the un-padded region into the maps
+  Cx3 const apo = Apodize(mat, LastN<3>(gridder.ishape), gridder.kernel) * fft_->phase().slice(LastN<3>(padLeft_), mat);
+  Cx5       mapsApo(maps.dimensions());
+  mapsApo.device(Threads::GlobalDevice()) =
+    maps * apo.reshape(AddFront(mat, 1, 1)).broadcast(Sz5{maps.dimension(0), nC, 1, 1, 1});
+  mapsApo_.emplace(mapsApo, precision);
+
+  mapsBatch_ = maps.dimensions();
+  mapsBatch_[1] = gridder.ishape[1];
+  brdMaps_ = Sz5{nB / maps.dimension(0), 1, 1, 1, 1};
+  resX_ = AddFront(mat, nB, 1);
+  brdX_ = Sz5{1, gridder.ishape[1], 1, 1, 1};
+}
+
+auto SENSENUFFT::Make(Trajectory const &traj, GridOpts &opts, Cx5 const &maps, Basis::CPtr basis)
+  -> std::shared_ptr<SENSENUFFT>
+{
+  if (opts.vcc) { Log::Fail("SENSENUFFT does not support VCC"); }
+  return std::make_shared<SENSENUFFT>(traj, opts.ktype.Get(), opts.osamp.Get(), maps, basis, opts.subgridSize.Get(),
+                                      opts.batches.Get(), opts.kTable.Get(), ParsePrecision(opts.precision.Get()));
+}
+
+void SENSENUFFT::forwardBatches(InCMap const &x, OutMap &y, bool const accumulate) const
+{
+  Arena::Lease ws(Product(gridder.ishape) * sizeof(Cx));
+  Cx5Map       wsm(ws.data<Cx>(), gridder.ishape);
+  Cx5CMap      wscm(ws.data<Cx>(), gridder.ishape);
+  Sz5          mst;
+  mst.fill(0);
+  if (!accumulate) { y.device(Threads::GlobalDevice()) = y.constant(0.f); }
+  for (Index ib = 0; ib < batches; ib++) {
+    mst[1] = ib * gridder.ishape[1];
+    mapsApo_->visit([&](auto const &m) {
+      wsm.device(Threads::GlobalDevice()) =
+        (x.reshape(resX_).broadcast(brdX_) * m.slice(mst, mapsBatch_).broadcast(brdMaps_)).pad(paddings_);
+    });
+    fft_->forwardPruned(wsm);
+    gridder.iforwardBatch(wscm, y, mst[1]);
+  }
+}
+
+void SENSENUFFT::adjointBatches(OutCMap const &y, InMap &x, bool const accumulate) const
+{
+  Arena::Lease ws(Product(gridder.ishape) * sizeof(Cx));
+  Cx5Map       wsm(ws.data<Cx>(), gridder.ishape);
+  Sz5          mst;
+  mst.fill(0);
+  for (Index ib = 0; ib < batches; ib++) {
+    mst[1] = ib * gridder.ishape[1];
+    gridder.adjointBatch(y, wsm, mst[1]);
+    fft_->adjointPruned(wsm);
+    mapsApo_->visit([&](auto const &m) {
+      auto const combined = DimDot<1>(wsm.slice(padLeft_, batchShape_), m.slice(mst, mapsBatch_).broadcast(brdMaps_));
+      if (ib == 0 && !accumulate) {
+        x.device(Threads::GlobalDevice()) = combined;
+      } else {
+        x.device(Threads::GlobalDevice()) += combined;
+      }
+    });
+  }
+}
+
+void SENSENUFFT::forward(InCMap const &x, OutMap &y) const
+{
+  auto const time = startForward(x, y, false);
+  forwardBatches(x, y, false);
+  finishForward(y, time, false);
+}
+
+void SENSENUFFT::adjoint(OutCMap const &y, InMap &x) const
+{
+  auto const time = startAdjoint(y, x, false);
+  adjointBatches(y, x, false);
+  finishAdjoint(x, time, false);
+}
+
+void SENSENUFFT::iforward(InCMap const &x, OutMap &y) const
+{
+  auto const time = startForward(x, y, true);
+  forwardBatches(x, y, true);
+  finishForward(y, time, true);
+}
+
+void SENSENUFFT::iadjoint(OutCMap const &y, InMap &x) const
+{
+  auto const time = startAdjoint(y, x, true);
+  adjointBatches(y, x, true);
+  finishAdjoint(x, time, true);
+}
+
+auto SENSENUFFT::nChannels() const -> Index { return oshape[0]; }
+
+} // namespace rl::TOps
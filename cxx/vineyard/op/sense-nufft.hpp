@@ -0,0 +1,58 @@
+#pragma once
+
+#include "op/top.hpp"
+
+#include "op/grid.hpp"
+
+#include "../compact.hpp"
+
+#include "../fft.hpp"
+
+#include <optional>
+
+namespace rl::TOps {
+
+/*
+ * SENSE followed by a (non-VCC) 3D NUFFT, without the intermediate channel images. The apodization and FFT-shift phase
+ * are folded into the maps, so the forward model writes x * maps straight into the padded FFT workspace one channel
+ * batch at a time, and the adjoint combines channels directly from the cropped IFFT output.
+ */
+struct SENSENUFFT final : TOp<Cx, 4, 3>
+{
+  TOP_INHERIT(Cx, 4, 3)
+  SENSENUFFT(Trajectory const  &traj,
+             std::string const &ktype,
+             float const        osamp,
+             Cx5 const         &maps,
+             Basis::CPtr        basis,
+             Index const        subgridSz = 32,
+             Index const        nBatches = 1,
+             Index const        kTableMB = 0,
+             Precision const    precision = Precision::Single);
+  TOP_DECLARE(SENSENUFFT)
+
+  static auto Make(Trajectory const &traj, GridOpts &opts, Cx5 const &maps, Basis::CPtr basis) -> std::shared_ptr<SENSENUFFT>;
+
+  void iforward(InCMap const &x, OutMap &y) const;
+  void iadjoint(OutCMap const &y, InMap &x) const;
+  auto nChannels() const -> Index;
+
+private:
+  void forwardBatches(InCMap const &x, OutMap &y, bool const accumulate) const;
+  void adjointBatches(OutCMap const &y, InMap &x, bool const accumulate) const;
+
+  Grid<3, false> gridder;
+  Index const    batches;
+
+  std::optional<FFT::Plan<5, 3>> fft_;
+
+  std::optional<CompactCx<5>> mapsApo_; // Maps × apodization × FFT-shift phase
+
+  Sz5 mapsBatch_, brdMaps_;  // Shape of one channel batch of the maps, and the basis broadcast
+  Sz5 resX_, brdX_;          // Reshape and broadcast of x to a channel batch
+  Sz5 batchShape_, padLeft_; // Un-padded batch within the grid workspace
+
+  std::array<std::pair<Index, Index>, 5> paddings_;
+};
+
+} // namespace rl::TOps
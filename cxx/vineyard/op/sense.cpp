@@ -11,11 +11,11 @@ constexpr float inv_sqrt2 = std::numbers::sqrt2 / 2;
 
 namespace rl::TOps {
 
-SENSE::SENSE(Cx5 const &maps, Index const nB)
+SENSE::SENSE(Cx5 const &maps, Index const nB, Precision const p)
   : Parent("SENSEOp",
            AddFront(LastN<3>(maps.dimensions()), nB),
            AddFront(LastN<3>(maps.dimensions()), nB, maps.dimension(1)))
-  , maps_{std::move(maps)}
+  , maps_{maps, p}
 {
   resX.set(0, nB);
   resX.set(2, maps_.dimension(2));
@@ -30,33 +30,38 @@ SENSE::SENSE(Cx5 const &maps, Index const nB)
   } else {
     Log::Fail("SENSE maps had basis size {}, expected {}", maps_.dimension(0), nB);
   }
+  if (p != Precision::Single) { Log::Print("SENSE maps stored at reduced precision, {} MB", maps_.bytes() / (1024 * 1024)); }
 }
 
 void SENSE::forward(InCMap const &x, OutMap &y) const
 {
   auto const time = startForward(x, y, false);
-  y.device(Threads::GlobalDevice()) = x.reshape(resX).broadcast(brdX) * maps_.broadcast(brdMaps);
+  maps_.visit([&](auto const &m) {
+    y.device(Threads::GlobalDevice()) = x.reshape(resX).broadcast(brdX) * m.broadcast(brdMaps);
+  });
   finishForward(y, time, false);
 }
 
 void SENSE::adjoint(OutCMap const &y, InMap &x) const
 {
   auto const time = startAdjoint(y, x, false);
-  x.device(Threads::GlobalDevice()) = DimDot<1>(y, maps_.broadcast(brdMaps));
+  maps_.visit([&](auto const &m) { x.device(Threads::GlobalDevice()) = DimDot<1>(y, m.broadcast(brdMaps)); });
   finishAdjoint(x, time, false);
 }
 
 void SENSE::iforward(InCMap const &x, OutMap &y) const
 {
   auto const time = startForward(x, y, true);
-  y.device(Threads::GlobalDevice()) += x.reshape(resX).broadcast(brdX) * maps_.broadcast(brdMaps);
+  maps_.visit([&](auto const &m) {
+    y.device(Threads::GlobalDevice()) += x.reshape(resX).broadcast(brdX) * m.broadcast(brdMaps);
+  });
   finishForward(y, time, true);
 }
 
 void SENSE::iadjoint(OutCMap const &y, InMap &x) const
 {
   auto const time = startAdjoint(y, x, true);
-  x.device(Threads::GlobalDevice()) += DimDot<1>(y, maps_.broadcast(brdMaps));
+  maps_.visit([&](auto const &m) { x.device(Threads::GlobalDevice()) += DimDot<1>(y, m.broadcast(brdMaps)); });
   finishAdjoint(x, time, true);
 }
 
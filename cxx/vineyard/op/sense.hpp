@@ -3,13 +3,14 @@
 #include "top.hpp"
 
 #include "basis/basis.hpp"
+#include "compact.hpp"
 
 namespace rl::TOps {
 
 struct SENSE final : TOp<Cx, 4, 5>
 {
   TOP_INHERIT(Cx, 4, 5)
-  SENSE(Cx5 const &maps, Index const nB = 1);
+  SENSE(Cx5 const &maps, Index const nB = 1, Precision const p = Precision::Single);
   TOP_DECLARE(SENSE)
   void iforward(InCMap const &x, OutMap &y) const;
   void iadjoint(OutCMap const &y, InMap &x) const;
@@ -17,7 +18,7 @@ struct SENSE final : TOp<Cx, 4, 5>
   auto mapDimensions() const -> Sz3;
 
 private:
-  Cx5                                                   maps_;
+  CompactCx<5>                                          maps_;
   Eigen::IndexList<int, FixOne, int, int, int>          resX;
   Eigen::IndexList<FixOne, int, FixOne, FixOne, FixOne> brdX;
   Eigen::IndexList<int, FixOne, FixOne, FixOne, FixOne> brdMaps;
@@ -1,6 +1,7 @@
 #include "top.hpp"
 
 #include "log.hpp"
+#include "profile.hpp"
 
 namespace rl::TOps {
 
@@ -100,6 +101,10 @@ auto TOp<S, I, O>::startForward(InCMap const &x, OutMap const &y, bool const ip)
   if (Log::CurrentLevel() == Log::Level::Debug) {
     Log::Debug("TOp{} {} forward {}->{} |x| {}", ip ? "-Add" : "", this->name, this->ishape, this->oshape, Norm(x));
   }
+  if (Profile::Enabled()) {
+    Index const bytes = (Product(ishape) + Product(oshape) * (ip ? 2 : 1)) * sizeof(S);
+    Profile::Begin(this->name + (ip ? " iforward" : " forward"), bytes);
+  }
   return Log::Now();
 }
 
@@ -108,6 +113,7 @@ template <typename S, int I, int O> void TOp<S, I, O>::finishForward(OutMap cons
   if (Log::CurrentLevel() == Log::Level::Debug) {
     Log::Debug("TOp{} {} forward finished in {} |y| {}.", ip ? "-Add" : "", this->name, Log::ToNow(start), Norm(y));
   }
+  Profile::End();
 }
 
 template <typename S, int I, int O>
@@ -118,6 +124,10 @@ auto TOp<S, I, O>::startAdjoint(OutCMap const &y, InMap const &x, bool const ip)
   if (Log::CurrentLevel() == Log::Level::Debug) {
     Log::Debug("TOp{} {} adjoint {}->{} |y| {}", ip ? "-Add" : "", this->name, this->oshape, this->ishape, Norm(y));
   }
+  if (Profile::Enabled()) {
+    Index const bytes = (Product(ishape) + Product(oshape) * (ip ? 2 : 1)) * sizeof(S);
+    Profile::Begin(this->name + (ip ? " iadjoint" : " adjoint"), bytes);
+  }
   return Log::Now();
 }
 
@@ -126,6 +136,7 @@ template <typename S, int I, int O> void TOp<S, I, O>::finishAdjoint(InMap const
   if (Log::CurrentLevel() == Log::Level::Debug) {
     Log::Debug("TOp{} {} adjoint finished in {} |x| {}", ip ? "-Add" : "", this->name, Log::ToNow(start), Norm(x));
   }
+  Profile::End();
 }
 
 // Yeah, this was likely a mistake
@@ -1,4 +1,5 @@
 #include "wavelets.hpp"
+#include "arena.hpp"
 #include "tensors.hpp"
 #include "threads.hpp"
 
@@ -62,70 +63,102 @@ template <int ND> void Wavelets<ND>::adjoint(OutCMap const &y, InMap &x) const
   this->finishAdjoint(x, time, false);
 }
 
+/*
+ * Lines along a dimension are processed in panels of consecutive lines. A panel is gathered into scratch as sz rows of
+ * nL lanes, so each filter tap is a contiguous multiply-add across the lanes. For every dimension except the first the
+ * lanes are neighbours along the fast axis, so the gather reads whole cache lines. The panels for every worker are leased
+ * once on the calling thread.
+ */
 template <int ND> void Wavelets<ND>::dimLoops(InMap &x, bool const reverse) const
 {
   for (auto const dim : dims_) {
-    auto const shuf = Range<ND>(dim, ND);
-    auto const otherDims = LastN<ND - 1>(shuf);
-    auto const maxSz = ishape[dim];
-    auto const otherSz = std::transform_reduce(otherDims.begin(), otherDims.end(), 1L, std::multiplies{},
-                                               [ish = this->ishape](size_t const ii) { return ish[ii]; });
+    Index const maxSz = ishape[dim];
+    Index const stride = std::accumulate(ishape.begin(), ishape.begin() + dim, 1L, std::multiplies{});
+    Index const otherSz = Product(ishape) / maxSz;
+    Index const nL = std::clamp(PanelSize / maxSz, 1L, otherSz);
 
     // Work out the smallest wavelet transform we can do on this dimension. Super annoying.
     Index minSz = maxSz;
     while ((minSz / 2) % 2 == 0 && minSz > 4) {
       minSz /= 2;
     }
-    auto wav_task = [&](Index const ii) {
-      Cx1 temp = x.shuffle(shuf).reshape(Sz2{maxSz, otherSz}).template chip<1>(ii);
-      if (reverse) {
-        for (Index sz = minSz; sz <= maxSz; sz *= 2) {
-          wav1(sz, reverse, temp);
+    Index const  wBytes = 2 * maxSz * nL * sizeof(Cx) + nL * sizeof(Index);
+    Arena::Lease lease(Threads::GlobalThreadCount() * wBytes);
+    auto         wav_task = [&](Index const lo, Index const hi, Index const iw) {
+      Cx *const    panel = reinterpret_cast<Cx *>(lease.data<std::byte>() + iw * wBytes);
+      Cx *const    work = panel + maxSz * nL;
+      Index *const bases = reinterpret_cast<Index *>(work + maxSz * nL);
+      for (Index ip = lo; ip < hi; ip++) {
+        Index const l0 = ip * nL;
+        Index const n = std::min(nL, otherSz - l0);
+        for (Index il = 0; il < n; il++) {
+          Index const line = l0 + il;
+          bases[il] = (line % stride) + (line / stride) * stride * maxSz;
         }
-      } else {
-        for (Index sz = maxSz; sz >= minSz; sz /= 2) {
-          wav1(sz, reverse, temp);
+        for (Index ii = 0; ii < maxSz; ii++) {
+          Cx const *const xi = x.data() + ii * stride;
+          Cx *const       pi = panel + ii * n;
+          for (Index il = 0; il < n; il++) {
+            pi[il] = xi[bases[il]];
+          }
+        }
+        if (reverse) {
+          for (Index sz = minSz; sz <= maxSz; sz *= 2) {
+            wav1(sz, reverse, n, panel, work);
+          }
+        } else {
+          for (Index sz = maxSz; sz >= minSz; sz /= 2) {
+            wav1(sz, reverse, n, panel, work);
+          }
+        }
+        for (Index ii = 0; ii < maxSz; ii++) {
+          Cx *const       xi = x.data() + ii * stride;
+          Cx const *const pi = panel + ii * n;
+          for (Index il = 0; il < n; il++) {
+            xi[bases[il]] = pi[il];
+          }
         }
       }
-      x.shuffle(shuf).reshape(Sz2{maxSz, otherSz}).template chip<1>(ii) = temp;
     };
 
-    Threads::For(wav_task, otherSz);
+    Threads::ParallelFor(0, (otherSz + nL - 1) / nL, 0, wav_task);
     Log::Debug("Wavelets Encode Dimension {}", dim);
   }
 }
 
-template <int ND> void Wavelets<ND>::wav1(Index const sz, bool const reverse, Cx1 &x) const
+template <int ND> void Wavelets<ND>::wav1(Index const sz, bool const reverse, Index const nL, Cx *x, Cx *w) const
 {
   if (sz < 4) return;
   if (sz % 2 == 1) return;
 
-  Cx1 w(sz);
-  w.setZero();
+  using Row = Eigen::Map<Eigen::ArrayXcf>;
+  Row         ws(w, sz * nL);
   Index const Noff = -N_ / 2;
   Index const hSz = sz / 2;
+  ws.setZero();
   if (reverse) {
     for (Index ii = 0; ii < hSz; ii++) {
-      Cx const    xLo = x[ii];
-      Cx const    xHi = x[ii + hSz];
+      Row const   xLo(x + ii * nL, nL);
+      Row const   xHi(x + (ii + hSz) * nL, nL);
       Index const index = 2 * ii + Noff;
       for (Index k = 0; k < N_; k++) {
-        Index const wrapped = Wrap(index + k, sz);
-        w[wrapped] += Cc_[k] * xLo;
-        w[wrapped] += Cr_[k] * xHi;
+        Row wr(w + Wrap(index + k, sz) * nL, nL);
+        wr += Cc_[k] * xLo + Cr_[k] * xHi;
       }
     }
   } else {
     for (Index ii = 0; ii < hSz; ii++) {
+      Row         wLo(w + ii * nL, nL);
+      Row         wHi(w + (ii + hSz) * nL, nL);
       Index const index = 2 * ii + Noff;
       for (Index k = 0; k < N_; k++) {
-        Index const wrapped = Wrap(index + k, sz);
-        w[ii] += Cc_[k] * x[wrapped];
-        w[ii + hSz] += Cr_[k] * x[wrapped];
+        Row const xr(x + Wrap(index + k, sz) * nL, nL);
+        wLo += Cc_[k] * xr;
+        wHi += Cr_[k] * xr;
       }
     }
   }
-  x.slice(Sz1{0}, Sz1{sz}) = w;
+  Row(x, sz * nL) = ws;
 }
 
 template struct Wavelets<4>;
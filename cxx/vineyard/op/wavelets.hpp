@@ -16,8 +16,10 @@ struct Wavelets final : TOp<Cx, ND, ND>
   static auto PaddedShape(Sz<ND> const shape, std::vector<Index> const dims) -> Sz<ND>;
 
 private:
+  static Index constexpr PanelSize = 1 << 14; // Elements per lane-interleaved panel of lines
+
   void  dimLoops(InMap &x, bool const rev) const;
-  void  wav1(Index const N, bool const rev, Cx1 &x) const;
+  void  wav1(Index const N, bool const rev, Index const nL, Cx *x, Cx *w) const; // In place on a panel of nL lanes
   Index N_;
   Re1   Cc_, Cr_; // Coefficients
   std::vector<Index> dims_;
@@ -1,11 +1,19 @@
 #include "patches.hpp"
 #include "log.hpp"
+#include "tensors.hpp"
 #include "threads.hpp"
 
+#include <random>
+
 namespace rl {
 
-void Patches(
-  Index const patchSize, Index const windowSize, bool const doShift, PatchFunction const &apply, Cx5CMap const &x, Cx5Map &y)
+void Patches(Index const                   patchSize,
+             Index const                   windowSize,
+             bool const                    doShift,
+             PatchInPlace const           &apply,
+             Cx5CMap const                &x,
+             Cx5Map                       &y,
+             std::optional<uint32_t> const seed)
 {
   Sz3 nWindows, shift;
 
@@ -15,8 +23,7 @@ void Patches(
   }
 
   if (doShift) {
-    std::random_device rd;
-    std::mt19937       gen(rd());
+    std::mt19937 gen(seed ? *seed : std::random_device()());
     for (Index ii = 0; ii < 3; ii++) {
       std::uniform_int_distribution<> int_dist(0, windowSize - 1);
       shift[ii] = int_dist(gen);
@@ -30,38 +37,48 @@ void Patches(
   Log::Debug("Windows {} Shifts {}", nWindows, shift);
   Sz5 const   szP{x.dimension(0), patchSize, patchSize, patchSize, x.dimension(4)};
   Index const inset = (patchSize - windowSize) / 2;
+  std::vector<Cx5> patches(Threads::GlobalThreadCount(), Cx5(szP));
 
-  for (Index iz = 0; iz < nWindows[2]; iz++) {
-    for (Index iy = 0; iy < nWindows[1]; iy++) {
-      auto xTask = [&](Index const ix) {
-        Sz3 ind{ix - 1, iy - 1, iz - 1};
-        Sz5 stP, stW, stW2, szW;
-        stP[0] = stW[0] = stW2[0] = 0;
-        stP[4] = stW[4] = stW2[4] = 0;
-        szW[0] = y.dimension(0);
-        szW[4] = y.dimension(4);
-        bool empty = false;
-        for (Index ii = 0; ii < 3; ii++) {
-          Index const d = x.dimension(ii + 1);
-          Index const st = ind[ii] * windowSize + shift[ii];
-          stW[ii + 1] = std::max(st, 0L);
-          szW[ii + 1] = windowSize + std::min({st, 0L, d - stW[ii + 1] - windowSize});
-          if (szW[ii + 1] < 1) {
-            empty = true;
-            break;
-          }
-          stP[ii + 1] = std::clamp(st - inset, 0L, d - patchSize);
-          stW2[ii + 1] = stW[ii + 1] - stP[ii + 1];
-        }
-        if (!empty) {
-          Cx5 xp = x.slice(stP, szP);
-          Cx5 yp = apply(xp);
-          y.slice(stW, szW) = yp.slice(stW2, szW);
-        }
-      };
-      Threads::For(xTask, nWindows[0], "Patches");
+  /* Windows do not overlap, so every window in the volume can be processed in one parallel loop writing straight to y */
+  auto task = [&](Index const iwin, Cx5 &xp, Index const iw) {
+    Sz3 const ind{iwin % nWindows[0] - 1, (iwin / nWindows[0]) % nWindows[1] - 1, iwin / (nWindows[0] * nWindows[1]) - 1};
+    Sz5       stP, stW, stW2, szW;
+    stP[0] = stW[0] = stW2[0] = 0;
+    stP[4] = stW[4] = stW2[4] = 0;
+    szW[0] = y.dimension(0);
+    szW[4] = y.dimension(4);
+    for (Index ii = 0; ii < 3; ii++) {
+      Index const d = x.dimension(ii + 1);
+      Index const st = ind[ii] * windowSize + shift[ii];
+      stW[ii + 1] = std::max(st, 0L);
+      szW[ii + 1] = windowSize + std::min({st, 0L, d - stW[ii + 1] - windowSize});
+      if (szW[ii + 1] < 1) { return; }
+      stP[ii + 1] = std::clamp(st - inset, 0L, d - patchSize);
+      stW2[ii + 1] = stW[ii + 1] - stP[ii + 1];
     }
-  }
+    xp = x.slice(stP, szP);
+    apply(xp, iw);
+    y.slice(stW, szW) = xp.slice(stW2, szW);
+  };
+  Threads::ParallelFor(
+    0, Product(nWindows), 0,
+    [&](Index const lo, Index const hi, Index const iw) {
+      for (Index iwin = lo; iwin < hi; iwin++) {
+        task(iwin, patches[iw], iw);
+      }
+    },
+    "Patches");
+}
+
+void Patches(Index const                   patchSize,
+             Index const                   windowSize,
+             bool const                    doShift,
+             PatchFunction const          &apply,
+             Cx5CMap const                &x,
+             Cx5Map                       &y,
+             std::optional<uint32_t> const seed)
+{
+  Patches(patchSize, windowSize, doShift, [&apply](Cx5 &xp, Index const) { xp = apply(xp); }, x, y, seed);
 }
 
 } // namespace rl
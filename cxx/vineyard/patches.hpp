@@ -1,10 +1,32 @@
 #include "types.hpp"
 
+#include <optional>
+
 namespace rl {
 
 using PatchFunction = std::function<Cx5(Cx5 const &)>;
 
-void Patches(
-  Index const patchSize, Index const windowSize, bool const shift, PatchFunction const &apply, Cx5CMap const &x, Cx5Map &y);
+/*
+ * Apply a function to overlapping patches and write the central windows of the results to y. With shift the window
+ * grid is offset randomly, and passing a seed makes the offset reproducible.
+ */
+void Patches(Index const                   patchSize,
+             Index const                   windowSize,
+             bool const                    shift,
+             PatchFunction const          &apply,
+             Cx5CMap const                &x,
+             Cx5Map                       &y,
+             std::optional<uint32_t> const seed = std::nullopt);
+
+/* Transforms the patch in place. The patch buffer belongs to the calling worker, so nothing is allocated per patch. */
+using PatchInPlace = std::function<void(Cx5 &patch, Index const worker)>;
+
+void Patches(Index const                   patchSize,
+             Index const                   windowSize,
+             bool const                    shift,
+             PatchInPlace const           &apply,
+             Cx5CMap const                &x,
+             Cx5Map                       &y,
+             std::optional<uint32_t> const seed = std::nullopt);
 
 } // namespace rl
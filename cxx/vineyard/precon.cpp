@@ -1,5 +1,6 @@
 #include "precon.hpp"
 
+#include "cache.hpp"
 #include "fft.hpp"
 #include "io/reader.hpp"
 #include "log.hpp"
@@ -10,11 +11,12 @@
 
 namespace rl {
 
+namespace {
 /*
  * Frank Ong's Preconditioner from https://ieeexplore.ieee.org/document/8906069/
  * (without SENSE maps)
  */
-auto KSpaceSingle(Trajectory const &traj, Basis::CPtr basis, bool const vcc, float const bias) -> Re2
+auto CalcKSpaceSingle(Trajectory const &traj, Basis::CPtr basis, bool const vcc, float const bias) -> Re2
 {
   Trajectory  newTraj(traj.points() * 2.f, Mul(traj.matrix(), 2), traj.voxelSize() * 2.f);
   float const osamp = 1.25;
@@ -30,10 +32,10 @@ auto KSpaceSingle(Trajectory const &traj, Basis::CPtr basis, bool const vcc, flo
     TOps::Pad<Cx, 6> padX(ones.dimensions(), psf.dimensions());
     Cx6              xcorr(padX.oshape);
     xcorr.device(Threads::GlobalDevice()) = padX.forward(ones);
-    auto const ph = FFT::PhaseShift(LastN<3>(xcorr.dimensions()));
-    FFT::Forward(xcorr, Sz3{3, 4, 5}, ph);
+    FFT::Plan const  fft(xcorr.dimensions(), Sz3{3, 4, 5});
+    fft.forward(xcorr);
     xcorr.device(Threads::GlobalDevice()) = xcorr * xcorr.conjugate();
-    FFT::Adjoint(xcorr, Sz3{3, 4, 5}, ph);
+    fft.adjoint(xcorr);
     xcorr.device(Threads::GlobalDevice()) = xcorr * psf;
     weights = nufft.forward(xcorr).abs().chip(0, 0);
     // I do not understand this scaling factor but it's in Frank's code and works
@@ -51,10 +53,10 @@ auto KSpaceSingle(Trajectory const &traj, Basis::CPtr basis, bool const vcc, flo
     TOps::Pad<Cx, 5> padX(ones.dimensions(), psf.dimensions());
     Cx5              xcorr(padX.oshape);
     xcorr.device(Threads::GlobalDevice()) = padX.forward(ones);
-    auto const ph = FFT::PhaseShift(LastN<3>(xcorr.dimensions()));
-    FFT::Forward(xcorr, Sz3{2, 3, 4}, ph);
+    FFT::Plan const  fft(xcorr.dimensions(), Sz3{2, 3, 4});
+    fft.forward(xcorr);
     xcorr.device(Threads::GlobalDevice()) = xcorr * xcorr.conjugate();
-    FFT::Adjoint(xcorr, Sz3{2, 3, 4}, ph);
+    fft.adjoint(xcorr);
     xcorr.device(Threads::GlobalDevice()) = xcorr * psf;
     weights = nufft.forward(xcorr).abs().chip(0, 0);
     // I do not understand this scaling factor but it's in Frank's code and works
@@ -71,6 +73,29 @@ auto KSpaceSingle(Trajectory const &traj, Basis::CPtr basis, bool const vcc, flo
   }
   return weights;
 }
+} // namespace
+
+auto KSpaceSingle(Trajectory const &traj, Basis::CPtr basis, bool const vcc, float const bias) -> Re2
+{
+  Index constexpr version = 1;
+  Cache::Key key;
+  key.add(version).add(traj.points().data(), traj.points().size()).add(traj.matrix()).add(vcc).add(bias);
+  if (basis) { key.add(basis->B.data(), basis->B.size()); }
+  if (auto const path = Cache::Lookup("precon", key)) {
+    try {
+      Re2 w = HD5::Reader(path.value()).readTensor<Re2>(HD5::Keys::Weights);
+      if (w.dimension(0) == traj.nSamples() && w.dimension(1) == traj.nTraces()) { return w; }
+      Log::Warn("Cached preconditioner dimensions {} did not match trajectory, recalculating", w.dimensions());
+    } catch (Log::Failure const &) {
+      Log::Warn("Could not read cached preconditioner, recalculating");
+    }
+  }
+  Re2 const w = CalcKSpaceSingle(traj, basis, vcc, bias);
+  Cache::Store("precon", key, [&w](HD5::Writer &writer) {
+    writer.writeTensor(HD5::Keys::Weights, w.dimensions(), w.data(), {"sample", "trace"});
+  });
+  return w;
+}
 
 auto MakeKspacePre(Trajectory const  &traj,
                    Index const        nC,
@@ -92,7 +117,7 @@ auto MakeKspacePre(Trajectory const  &traj,
     HD5::Reader reader(type);
     Re2         w = reader.readTensor<Re2>(HD5::Keys::Weights);
     if (w.dimension(0) != traj.nSamples() || w.dimension(1) != traj.nTraces()) {
-      Log::Fail("Preconditioner dimensions on disk {} did not match trajectory {}x{}", w.dimension(0), w.dimension(1),
+      Log::Fail("Preconditioner dimensions on disk {}x{} did not match trajectory {}x{}", w.dimension(0), w.dimension(1),
                 traj.nSamples(), traj.nTraces());
     }
     Eigen::VectorXcf const wv = CollapseToArray(w);
@@ -100,4 +125,23 @@ auto MakeKspacePre(Trajectory const  &traj,
   }
 }
 
+auto KSpaceWeights(Trajectory const &traj, Basis::CPtr basis, std::string const &type, float const bias) -> Re2
+{
+  Re2 w(traj.nSamples(), traj.nTraces());
+  if (type == "" || type == "none") {
+    w.setConstant(1.f);
+  } else if (type == "kspace") {
+    w.device(Threads::GlobalDevice()) = KSpaceSingle(traj, basis, false, bias).inverse();
+  } else {
+    HD5::Reader reader(type);
+    Re2 const   pre = reader.readTensor<Re2>(HD5::Keys::Weights);
+    if (pre.dimension(0) != traj.nSamples() || pre.dimension(1) != traj.nTraces()) {
+      Log::Fail("Preconditioner dimensions on disk {}x{} did not match trajectory {}x{}", pre.dimension(0), pre.dimension(1),
+                traj.nSamples(), traj.nTraces());
+    }
+    w.device(Threads::GlobalDevice()) = pre.inverse();
+  }
+  return w;
+}
+
 } // namespace rl
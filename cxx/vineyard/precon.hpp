@@ -18,4 +18,12 @@ auto MakeKspacePre(Trajectory const  &traj,
                    float const        bias = 1.f,
                    bool const         ndft = false) -> std::shared_ptr<Ops::Op<Cx>>;
 
+/*
+ * The k-space weights M⁻¹ that LSMR applies with the preconditioner M, i.e. the W in the normal equations A'WA
+ */
+auto KSpaceWeights(Trajectory const  &traj,
+                   Basis::CPtr        basis,
+                   std::string const &type = "kspace",
+                   float const        bias = 1.f) -> Re2;
+
 } // namespace rl
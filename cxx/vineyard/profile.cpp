@@ -0,0 +1,169 @@
+#include "profile.hpp"
+
+#include "log.hpp"
+#include "threads.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace rl {
+namespace Profile {
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Frame
+{
+  std::string       path;
+  Clock::time_point start;
+  Index             bytes;
+  double            busy = 0.;
+};
+
+struct Stat
+{
+  Index  calls = 0, bytes = 0;
+  double seconds = 0., busy = 0.;
+};
+
+struct Event
+{
+  std::string name;
+  Index       ts, dur, bytes;
+  Index       tid;
+};
+
+/* Order call paths so that children follow their parent, i.e. treat the separator as the lowest character */
+struct PathOrder
+{
+  auto operator()(std::string const &a, std::string const &b) const -> bool
+  {
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](char const x, char const y) {
+      return (x == '/' ? '\0' : x) < (y == '/' ? '\0' : y);
+    });
+  }
+};
+
+Index constexpr MaxEvents = 1 << 20;
+
+std::atomic<bool>                      enabled{false};
+std::string                            traceFile;
+Clock::time_point                      origin;
+std::mutex                             mutex;
+std::map<std::string, Stat, PathOrder> stats;
+std::vector<Event>                     events;
+Index                                  dropped = 0;
+std::atomic<Index>                     nextTid{0};
+
+thread_local std::vector<Frame> stack;
+thread_local std::string        base;
+thread_local Index const        tid = nextTid++;
+
+auto Micro(Clock::duration const d) -> Index { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); }
+} // namespace
+
+void Enable(std::string const &file)
+{
+  traceFile = file;
+  origin = Clock::now();
+  enabled = true;
+  Log::Print("Profiling operators{}", file.empty() ? "" : fmt::format(", trace file {}", file));
+}
+
+auto Enabled() -> bool { return enabled.load(std::memory_order_relaxed); }
+
+void Begin(std::string const &name, Index const bytes)
+{
+  if (!Enabled()) { return; }
+  auto const &parent = stack.empty() ? base : stack.back().path;
+  stack.push_back(Frame{parent.empty() ? name : parent + "/" + name, Clock::now(), bytes});
+}
+
+void End()
+{
+  if (!Enabled() || stack.empty()) { return; }
+  auto const  now = Clock::now();
+  Frame const f = std::move(stack.back());
+  stack.pop_back();
+  std::scoped_lock lock(mutex);
+  auto            &s = stats[f.path];
+  s.calls++;
+  s.bytes += f.bytes;
+  s.seconds += std::chrono::duration<double>(now - f.start).count();
+  s.busy += f.busy;
+  if (!traceFile.empty()) {
+    if (static_cast<Index>(events.size()) < MaxEvents) {
+      auto const slash = f.path.find_last_of('/');
+      events.push_back(Event{slash == std::string::npos ? f.path : f.path.substr(slash + 1), Micro(f.start - origin),
+                             Micro(now - f.start), f.bytes, tid});
+    } else {
+      dropped++;
+    }
+  }
+}
+
+void AddBusy(double const threadSeconds)
+{
+  if (!Enabled()) { return; }
+  for (auto &f : stack) {
+    f.busy += threadSeconds;
+  }
+}
+
+auto CurrentPath() -> std::string { return stack.empty() ? base : stack.back().path; }
+
+Scope::Scope(char const *name, Index const bytes)
+  : active_{Enabled()}
+{
+  if (active_) { Begin(name, bytes); }
+}
+
+Scope::~Scope()
+{
+  if (active_) { End(); }
+}
+
+Inherit::Inherit(std::string const &path)
+  : previous_{base}
+{
+  base = path;
+}
+
+Inherit::~Inherit() { base = previous_; }
+
+void Finish()
+{
+  if (!Enabled()) { return; }
+  std::scoped_lock lock(mutex);
+  float const      nT = Threads::GlobalThreadCount();
+  Log::Print("{:<60} {:>8} {:>10} {:>10} {:>8} {:>6}", "Operator", "Calls", "Total (s)", "Mean (ms)", "GB/s", "Util");
+  for (auto const &[path, s] : stats) {
+    Index const depth = std::count(path.begin(), path.end(), '/');
+    auto const  slash = path.find_last_of('/');
+    auto const  name = std::string(2 * depth, ' ') + (slash == std::string::npos ? path : path.substr(slash + 1));
+    auto const  util = s.busy > 0. ? fmt::format("{:.0f}%", 100. * s.busy / (s.seconds * nT)) : std::string("-");
+    Log::Print("{:<60} {:>8} {:>10.3f} {:>10.3f} {:>8.2f} {:>6}", name, s.calls, s.seconds, 1.e3 * s.seconds / s.calls,
+               s.seconds > 0. ? s.bytes / (s.seconds * 1.e9) : 0., util);
+  }
+  if (traceFile.empty()) { return; }
+  std::ofstream f(traceFile);
+  if (!f) { Log::Fail("Could not open trace file {}", traceFile); }
+  f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t ii = 0; ii < events.size(); ii++) {
+    auto const &e = events[ii];
+    f << fmt::format("{}\n{{\"name\":\"{}\",\"cat\":\"op\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":0,\"tid\":{},"
+                     "\"args\":{{\"bytes\":{}}}}}",
+                     ii ? "," : "", e.name, e.ts, e.dur, e.tid, e.bytes);
+  }
+  f << "\n]}\n";
+  Log::Print("Wrote {} trace events to {}", events.size(), traceFile);
+  if (dropped) { Log::Warn("Dropped {} trace events above the limit of {}", dropped, MaxEvents); }
+}
+
+} // namespace Profile
+} // namespace rl
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <string>
+
+namespace rl {
+
+/*
+ * Operator profiling. When enabled, every TOp application (and any other Scope) records its wall time and the bytes
+ * of its input and output, nested under the scopes already open on the calling thread. Work handed to the thread pool
+ * by Threads::ParallelFor is nested under the scope that scheduled it, and the busy time of the pool workers is
+ * credited to every open scope, which gives the thread utilisation.
+ *
+ * Finish() prints a summary table aggregated by call path, and writes each call as a Chrome trace_event (viewable in
+ * chrome://tracing or Perfetto) if a trace file was given.
+ */
+namespace Profile {
+
+void Enable(std::string const &traceFile = "");
+auto Enabled() -> bool;
+void Finish();
+
+void Begin(std::string const &name, Index const bytes);
+void End();
+void AddBusy(double const threadSeconds);
+
+/* Open a scope for the lifetime of this object, if profiling is enabled */
+struct Scope
+{
+  Scope(char const *name, Index const bytes = 0);
+  ~Scope();
+  Scope(Scope const &) = delete;
+  Scope &operator=(Scope const &) = delete;
+
+private:
+  bool active_;
+};
+
+/* The call path of the innermost open scope on this thread */
+auto CurrentPath() -> std::string;
+
+/* Make scopes opened on this thread children of path, e.g. in a pool worker running on behalf of another thread */
+struct Inherit
+{
+  Inherit(std::string const &path);
+  ~Inherit();
+
+private:
+  std::string previous_;
+};
+
+} // namespace Profile
+} // namespace rl
@@ -1,10 +1,16 @@
 #include "entropy.hpp"
 
+#include "algo/blas.hpp"
 #include "log.hpp"
 #include "tensors.hpp"
+#include "threads.hpp"
 
 namespace rl::Proxs {
 
+namespace {
+Index constexpr Grain = 1 << 12; // Elements per parallel block, small enough that the iterates stay in cache
+}
+
 Entropy::Entropy(float const λ_, Index const sz_)
   : Prox<Cx>(sz_)
   , λ{λ_}
@@ -14,15 +20,17 @@ Entropy::Entropy(float const λ_, Index const sz_)
 
 void Entropy::apply(float const α, CMap const &v, Map &z) const
 {
-  float const          t = α * λ;
-  Eigen::ArrayXf const vabs = v.array().abs();
-  Eigen::ArrayXf       x = vabs;
-  for (int ii = 0; ii < 16; ii++) {
-    auto const g = (x > 0.f).select((x.log() + 1.f) + (1.f / t) * (x - vabs), 0.f);
-    x = (x - (t / 2.f) * g).cwiseMax(0.f);
-  }
-  z = v.array() * (x / vabs);
-  Log::Debug("Entropy α {} λ {} t {} |v| {} |z| {}", α, λ, t, v.stableNorm(), z.stableNorm());
+  float const t = α * λ;
+  Threads::ParallelFor(0, v.size(), Grain, [&](Index const lo, Index const hi) {
+    Eigen::ArrayXf const vabs = v.segment(lo, hi - lo).array().abs();
+    Eigen::ArrayXf       x = vabs;
+    for (int ii = 0; ii < 16; ii++) {
+      auto const g = (x > 0.f).select((x.log() + 1.f) + (1.f / t) * (x - vabs), 0.f);
+      x = (x - (t / 2.f) * g).cwiseMax(0.f);
+    }
+    z.segment(lo, hi - lo) = v.segment(lo, hi - lo).array() * (x / vabs);
+  });
+  Log::Debug("Entropy α {} λ {} t {} |v| {} |z| {}", α, λ, t, BLAS::Norm(v), BLAS::Norm(z));
 }
 
 NMREntropy::NMREntropy(float const λ_, Index const sz_)
@@ -34,16 +42,18 @@ NMREntropy::NMREntropy(float const λ_, Index const sz_)
 
 void NMREntropy::apply(float const α, CMap const &v, Map &z) const
 {
-  float const          t = α * λ;
-  Eigen::ArrayXf const vabs = v.array().abs();
-  Eigen::ArrayXf       x = vabs;
-  for (int ii = 0; ii < 16; ii++) {
-    auto const xx = (x.square() + 1.f).sqrt();
-    auto const g = ((x * (x / xx + 1.f)) / (x + xx) + (x + xx).log() - x / xx) + (1.f / t) * (x - vabs);
-    x = (x - (t / 2.f) * g).cwiseMax(0.f);
-  }
-  z = v.array() * (x / vabs);
-  Log::Debug("NMR Entropy α {} λ {} t {} |v| {} |z| {}", α, λ, t, v.stableNorm(), z.stableNorm());
+  float const t = α * λ;
+  Threads::ParallelFor(0, v.size(), Grain, [&](Index const lo, Index const hi) {
+    Eigen::ArrayXf const vabs = v.segment(lo, hi - lo).array().abs();
+    Eigen::ArrayXf       x = vabs;
+    for (int ii = 0; ii < 16; ii++) {
+      auto const xx = (x.square() + 1.f).sqrt();
+      auto const g = ((x * (x / xx + 1.f)) / (x + xx) + (x + xx).log() - x / xx) + (1.f / t) * (x - vabs);
+      x = (x - (t / 2.f) * g).cwiseMax(0.f);
+    }
+    z.segment(lo, hi - lo) = v.segment(lo, hi - lo).array() * (x / vabs);
+  });
+  Log::Debug("NMR Entropy α {} λ {} t {} |v| {} |z| {}", α, λ, t, BLAS::Norm(v), BLAS::Norm(z));
 }
 
 } // namespace rl::Proxs
@@ -1,9 +1,9 @@
 #include "llr.hpp"
 
-#include "algo/decomp.hpp"
 #include "log.hpp"
 #include "patches.hpp"
 #include "tensors.hpp"
+#include "threads.hpp"
 
 namespace rl::Proxs {
 
@@ -25,22 +25,23 @@ LLR::LLR(float const l, Index const p, Index const w, bool const doShift, Sz5 co
   Log::Print("Locally Low-Rank λ {} Scaled λ {} Patch {} Window {}", l, λ, patchSize, windowSize);
 }
 
+void LLR::shrink(float const realλ, Cx5CMap const &x, Cx5Map &z) const
+{
+  Index const nT = Threads::GlobalThreadCount();
+  if ((Index)shrinks.size() < nT) {
+    shrinks.resize(nT, SVDShrink(shape[0], patchSize * patchSize * patchSize * shape[4]));
+  }
+  auto       softLLR = [&](Cx5 &xp, Index const iw) { shrinks[iw].apply(realλ, CollapseToMatrix(xp)); };
+  auto const applySeed = seed ? std::optional<uint32_t>(*seed + applied.fetch_add(1)) : std::nullopt;
+  Patches(patchSize, windowSize, shift, softLLR, x, z, applySeed);
+}
+
 void LLR::apply(float const α, CMap const &xin, Map &zin) const
 {
   Cx5CMap     x(xin.data(), shape);
   Cx5Map      z(zin.data(), shape);
   float const realλ = λ * α;
-
-  auto softLLR = [realλ](Cx5 const &xp) {
-    Eigen::MatrixXcf patch = CollapseToMatrix(xp);
-    auto const       svd = SVD<Cx>(patch.transpose());
-    // Soft-threhold svals
-    Eigen::VectorXf const s = (svd.S.abs() > realλ).select(svd.S * (svd.S.abs() - realλ) / svd.S.abs(), 0.f);
-    patch = (svd.U * s.asDiagonal() * svd.V.adjoint()).transpose();
-    Cx5 yp = Tensorfy(patch, xp.dimensions());
-    return yp;
-  };
-  Patches(patchSize, windowSize, shift, softLLR, x, z);
+  shrink(realλ, x, z);
   Log::Debug("LLR α {} λ {} t {} |x| {} |z| {}", α, λ, realλ, Norm(x), Norm(z));
 }
 
@@ -50,17 +51,7 @@ void LLR::apply(std::shared_ptr<Op> const α, CMap const &xin, Map &zin) const
     Cx5CMap     x(xin.data(), shape);
     Cx5Map      z(zin.data(), shape);
     float const realλ = λ * realα->scale * std::sqrt(patchSize * patchSize * patchSize);
-
-    auto softLLR = [realλ](Cx5 const &xp) {
-      Eigen::MatrixXcf patch = CollapseToMatrix(xp);
-      auto const       svd = SVD<Cx>(patch.transpose());
-      // Soft-threhold svals
-      Eigen::VectorXf const s = (svd.S.abs() > realλ).select(svd.S * (svd.S.abs() - realλ) / svd.S.abs(), 0.f);
-      patch = (svd.U * s.asDiagonal() * svd.V.adjoint()).transpose();
-      Cx5 yp = Tensorfy(patch, xp.dimensions());
-      return yp;
-    };
-    Patches(patchSize, windowSize, shift, softLLR, x, z);
+    shrink(realλ, x, z);
     Log::Debug("LLR α {} λ {} t {} |x| {} |z| {}", realα->scale, λ, realλ, Norm(x), Norm(z));
   } else {
     Log::Fail("C++ is stupid");
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "algo/decomp.hpp"
 #include "prox.hpp"
 
+#include <atomic>
+#include <optional>
+
 namespace rl::Proxs {
 
 /*
@@ -17,10 +21,19 @@ struct LLR final : Prox<Cx>
   Index patchSize, windowSize;
   Sz5   shape;
   bool  shift;
+
+  std::optional<uint32_t> seed; // With shift, makes the sequence of window offsets reproducible
+
   LLR(float const, Index const, Index const, bool const, Sz5 const);
 
   void apply(float const α, CMap const &x, Map &z) const;
   void apply(std::shared_ptr<Op> const α, CMap const &x, Map &z) const;
+
+private:
+  mutable std::atomic<uint32_t>  applied = 0; // Advances the seed between applications
+  mutable std::vector<SVDShrink> shrinks;     // Per-worker workspaces, kept between applications
+
+  void shrink(float const realλ, Cx5CMap const &x, Cx5Map &z) const; // Soft-threshold the singular values of each patch
 };
 
 } // namespace rl::Proxs
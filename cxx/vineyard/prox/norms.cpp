@@ -1,10 +1,51 @@
 #include "norms.hpp"
 
+#include "algo/blas.hpp"
 #include "log.hpp"
 #include "tensors.hpp"
+#include "threads.hpp"
 
 namespace rl::Proxs {
 
+namespace {
+Index constexpr Grain = 1 << 14; // Elements per parallel block for elementwise proxes
+
+void SoftThreshold(float const t, Eigen::Map<Eigen::VectorXcf const> const &x, Eigen::Map<Eigen::VectorXcf> &z)
+{
+  Threads::ParallelFor(0, x.size(), Grain, [&](Index const lo, Index const hi) {
+    auto const xs = x.segment(lo, hi - lo);
+    z.segment(lo, hi - lo) =
+      xs.cwiseAbs().cwiseTypedGreater(t).select(xs.array() * (xs.array().abs() - t) / xs.array().abs(), 0.f);
+  });
+}
+
+/* Blocks are shrunk independently, so are spread across the pool. A single block needs the parallel norm first. */
+void BlockShrink(float const                               t,
+                 Index const                               blockSize,
+                 Eigen::Map<Eigen::VectorXcf const> const &x,
+                 Eigen::Map<Eigen::VectorXcf>             &z)
+{
+  auto scale = [&](Index const lo, Index const n, float const norm) {
+    if (norm > t) {
+      z.segment(lo, n) = x.segment(lo, n) * (1.f - t / norm);
+    } else {
+      z.segment(lo, n).setZero();
+    }
+  };
+  auto const blks = x.rows() / blockSize;
+  if (blks == 1) {
+    float const norm = BLAS::Norm(x);
+    Threads::ParallelFor(0, x.size(), Grain, [&](Index const lo, Index const hi) { scale(lo, hi - lo, norm); });
+  } else {
+    Threads::ParallelFor(0, blks, std::max<Index>(1, Grain / blockSize), [&](Index const lo, Index const hi) {
+      for (Index ib = lo; ib < hi; ib++) {
+        scale(ib * blockSize, blockSize, x.segment(ib * blockSize, blockSize).stableNorm());
+      }
+    });
+  }
+}
+} // namespace
+
 L1::L1(float const λ_, Index const sz_)
   : Prox<Cx>(sz_)
   , λ{λ_}
@@ -15,16 +56,16 @@ L1::L1(float const λ_, Index const sz_)
 void L1::apply(float const α, CMap const &x, Map &z) const
 {
   float t = α * λ;
-  z = x.cwiseAbs().cwiseTypedGreater(t).select(x.array() * (x.array().abs() - t) / x.array().abs(), 0.f);
-  Log::Debug("Soft Threshold α {} λ {} t {} |x| {} |z| {}", α, λ, t, x.stableNorm(), z.stableNorm());
+  SoftThreshold(t, x, z);
+  Log::Debug("Soft Threshold α {} λ {} t {} |x| {} |z| {}", α, λ, t, BLAS::Norm(x), BLAS::Norm(z));
 }
 
 void L1::apply(std::shared_ptr<Op> const α, CMap const &x, Map &z) const
 {
   if (auto realα = std::dynamic_pointer_cast<Ops::DiagScale<Cx>>(α)) {
     float t = λ * realα->scale;
-    z = x.cwiseAbs().cwiseTypedGreater(t).select(x.array() * (x.array().abs() - t) / x.array().abs(), 0.f);
-    Log::Debug("Soft Threshold λ {} t {} |x| {} |z| {}", λ, t, x.stableNorm(), z.stableNorm());
+    SoftThreshold(t, x, z);
+    Log::Debug("Soft Threshold λ {} t {} |x| {} |z| {}", λ, t, BLAS::Norm(x), BLAS::Norm(z));
   } else {
     Log::Fail("C++ is stupid");
   }
@@ -43,32 +84,16 @@ L2::L2(float const λ_, Index const sz_, Index const blk)
 void L2::apply(float const α, CMap const &x, Map &z) const
 {
   float const t = α * λ;
-  auto const  blks = x.rows() / blockSize;
-  for (Index ib = 0; ib < blks; ib++) {
-    auto const n = x.segment(ib * blockSize, blockSize).stableNorm();
-    if (n > t) {
-      z.segment(ib * blockSize, blockSize) = x.segment(ib * blockSize, blockSize) * (1.f - t / n);
-    } else {
-      z.segment(ib * blockSize, blockSize).setZero();
-    }
-  }
-  Log::Debug("L2 Prox α {} λ {} t {} |x| {} |z| {}", α, λ, t, x.stableNorm(), z.stableNorm());
+  BlockShrink(t, blockSize, x, z);
+  Log::Debug("L2 Prox α {} λ {} t {} |x| {} |z| {}", α, λ, t, BLAS::Norm(x), BLAS::Norm(z));
 }
 
 void L2::apply(std::shared_ptr<Op> const α, CMap const &x, Map &z) const
 {
   if (auto realα = std::dynamic_pointer_cast<Ops::DiagScale<Cx>>(α)) {
-    float      t = λ * realα->scale;
-    auto const blks = x.rows() / blockSize;
-    for (Index ib = 0; ib < blks; ib++) {
-      auto const n = x.segment(ib * blockSize, blockSize).stableNorm();
-      if (n > t) {
-        z.segment(ib * blockSize, blockSize) = x.segment(ib * blockSize, blockSize) * (1.f - t / n);
-      } else {
-        z.segment(ib * blockSize, blockSize).setZero();
-      }
-    }
-    Log::Debug("L2 Prox λ {} t {} |x| {} |z| {}", λ, t, x.stableNorm(), z.stableNorm());
+    float t = λ * realα->scale;
+    BlockShrink(t, blockSize, x, z);
+    Log::Debug("L2 Prox λ {} t {} |x| {} |z| {}", λ, t, BLAS::Norm(x), BLAS::Norm(z));
   } else {
     Log::Fail("C++ is stupid");
   }
@@ -1,6 +1,7 @@
 #include "stack.hpp"
 
 #include "log.hpp"
+#include "threads.hpp"
 
 namespace rl::Proxs {
 
@@ -10,6 +11,7 @@ StackProx<S>::StackProx(std::vector<std::shared_ptr<Prox<S>>> const ps)
       std::accumulate(ps.begin(), ps.end(), 0L, [](Index const i, std::shared_ptr<Prox<S>> const &p) { return i + p->sz; }))
   , proxs{ps}
 {
+  setStarts();
 }
 
 template <typename S>
@@ -20,34 +22,47 @@ StackProx<S>::StackProx(std::shared_ptr<Prox<S>> p1, std::vector<std::shared_ptr
   , proxs{p1}
 {
   proxs.insert(proxs.end(), ps.begin(), ps.end());
+  setStarts();
 }
 
-template <typename S>
-void StackProx<S>::apply(float const α, CMap const &x, Map &z) const
+template <typename S> void StackProx<S>::setStarts()
 {
+  starts.resize(proxs.size());
   Index st = 0;
-  for (auto &p : proxs) {
-    CMap const xm(x.data() + st, p->sz);
-    Map        zm(z.data() + st, p->sz);
-    p->apply(α, xm, zm);
-    st += p->sz;
+  for (size_t ii = 0; ii < proxs.size(); ii++) {
+    starts[ii] = st;
+    st += proxs[ii]->sz;
   }
 }
 
+template <typename S>
+void StackProx<S>::apply(float const α, CMap const &x, Map &z) const
+{
+  /* Each prox owns a disjoint segment of x and z, so they can all run at once */
+  Threads::Concurrent(
+    [&](Index const ii) {
+      auto      &p = proxs[ii];
+      CMap const xm(x.data() + starts[ii], p->sz);
+      Map        zm(z.data() + starts[ii], p->sz);
+      p->apply(α, xm, zm);
+    },
+    proxs.size());
+}
+
 template <typename S>
 void StackProx<S>::apply(std::shared_ptr<Ops::Op<S>> const αs1, CMap const &x, Map &z) const
 {
   if (auto const αs = std::dynamic_pointer_cast<Ops::DStack<S>>(αs1)) {
     assert(αs->ops.size() == proxs.size());
-    Index st = 0;
-    for (size_t ii = 0; ii < proxs.size(); ii++) {
-      auto      &p = proxs[ii];
-      auto      &α = αs->ops[ii];
-      CMap const xm(x.data() + st, p->sz);
-      Map        zm(z.data() + st, p->sz);
-      p->apply(α, xm, zm);
-      st += p->sz;
-    }
+    Threads::Concurrent(
+      [&](Index const ii) {
+        auto      &p = proxs[ii];
+        auto      &α = αs->ops[ii];
+        CMap const xm(x.data() + starts[ii], p->sz);
+        Map        zm(z.data() + starts[ii], p->sz);
+        p->apply(α, xm, zm);
+      },
+      proxs.size());
   } else {
     Log::Fail("C++ is stupid");
   }
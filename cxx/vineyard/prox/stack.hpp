@@ -22,6 +22,9 @@ struct StackProx final : Prox<Scalar>
 
 private:
   std::vector<std::shared_ptr<Prox<Scalar>>> proxs;
+  std::vector<Index>                         starts;
+
+  void setStarts();
 };
 
 } // namespace rl::Proxs
@@ -24,6 +24,7 @@ RegOpts::RegOpts(args::Subparser &parser)
   , llrPatch(parser, "S", "Patch size for LLR (default 5)", {"llr-patch"}, 5)
   , llrWin(parser, "S", "Window size for LLR (default 3)", {"llr-win"}, 3)
   , llrShift(parser, "S", "Enable random LLR shifting", {"llr-shift"})
+  , llrSeed(parser, "N", "Seed for the LLR shifts, for reproducible results", {"llr-seed"})
 
   , wavelets(parser, "L", "L1 Wavelet denoising", {"wavelets"})
   , waveDims(parser, "W", "Wavelet transform dimensions (b,x,y,z 0/1)", {"wavelet-dims"}, std::vector<Index>{1,2,3})
@@ -75,9 +76,9 @@ auto Regularizers(RegOpts &opts, TOps::TOp<Cx, 5, 5>::Ptr const &recon) -> Regul
   }
 
   if (opts.llr) {
-    regs.push_back({std::make_shared<Ops::Multiply<Cx>>(std::make_shared<TOps::Identity<Cx, 5>>(shape), ext_x),
-                    std::make_shared<Proxs::LLR>(opts.llr.Get(), opts.llrPatch.Get(), opts.llrWin.Get(), opts.llrShift, shape),
-                    shape});
+    auto p = std::make_shared<Proxs::LLR>(opts.llr.Get(), opts.llrPatch.Get(), opts.llrWin.Get(), opts.llrShift, shape);
+    if (opts.llrSeed) { p->seed = opts.llrSeed.Get(); }
+    regs.push_back({std::make_shared<Ops::Multiply<Cx>>(std::make_shared<TOps::Identity<Cx, 5>>(shape), ext_x), p, shape});
   }
 
   if (opts.l1) {
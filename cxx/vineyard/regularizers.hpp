@@ -25,6 +25,7 @@ struct RegOpts
   args::ValueFlag<Index> llrPatch;
   args::ValueFlag<Index> llrWin;
   args::Flag             llrShift;
+  args::ValueFlag<Index> llrSeed;
 
   args::ValueFlag<float>                                   wavelets;
   args::ValueFlag<std::vector<Index>, VectorReader<Index>> waveDims;
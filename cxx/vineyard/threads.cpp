@@ -11,14 +11,23 @@
 
 #include "threads.hpp"
 #include "log.hpp"
+#include "profile.hpp"
 
 // Need to define EIGEN_USE_THREADS before including these. This is done in CMakeLists.txt
 #include <unsupported/Eigen/CXX11/Tensor>
 #include <unsupported/Eigen/CXX11/ThreadPool>
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 namespace {
 std::unique_ptr<Eigen::ThreadPool>       gp = nullptr;
 std::unique_ptr<Eigen::ThreadPoolDevice> dev = nullptr;
+std::unique_ptr<Eigen::ThreadPoolDevice> serial = nullptr;
 } // namespace
 
 namespace rl {
@@ -40,6 +49,7 @@ void SetGlobalThreadCount(Index nt)
   Log::Debug("Creating thread pool with {} threads", nt);
   gp = std::make_unique<Eigen::ThreadPool>(nt);
   dev = std::make_unique<Eigen::ThreadPoolDevice>(gp.get(), nt);
+  serial = std::make_unique<Eigen::ThreadPoolDevice>(gp.get(), 1);
 }
 
 Index GlobalThreadCount() { return GlobalPool()->NumThreads(); }
@@ -49,38 +59,236 @@ Eigen::ThreadPoolDevice &GlobalDevice()
   if (dev == nullptr) {
     auto gp = GlobalPool();
     dev = std::make_unique<Eigen::ThreadPoolDevice>(gp, gp->NumThreads());
+    serial = std::make_unique<Eigen::ThreadPoolDevice>(gp, 1);
   }
-  return *dev;
+  /* Tensor expressions evaluated by a pool thread, e.g. inside a concurrent Loop, must not block waiting on the pool */
+  return GlobalPool()->CurrentThreadId() < 0 ? *dev : *serial;
 }
 
-void For(ForFunc f, Index const lo, Index const hi, std::string const &label)
+namespace {
+/* Each worker owns the blocks [next, end). The owner takes from the front, thieves from the back. */
+struct alignas(64) Worker
+{
+  std::mutex m;
+  Index      next = 0, end = 0;
+  Index      blocks = 0, steals = 0;
+  double     busy = 0.;
+
+  auto pop() -> Index
+  {
+    std::scoped_lock lock(m);
+    return next < end ? next++ : -1;
+  }
+
+  auto remaining() -> Index
+  {
+    std::scoped_lock lock(m);
+    return end - next;
+  }
+
+  auto steal(Index &lo, Index &hi) -> bool
+  {
+    std::scoped_lock lock(m);
+    Index const n = end - next;
+    if (n < 1) { return false; }
+    hi = end;
+    end -= (n + 1) / 2;
+    lo = end;
+    return true;
+  }
+};
+} // namespace
+
+void ParallelFor(Index const lo, Index const hi, Index const grainIn, WorkerRangeFunc f, std::string const &label)
 {
   Index const ni = hi - lo;
-  Index const nt = GlobalPool()->NumThreads();
-  if (ni == 0) { return; }
+  if (ni < 1) { return; }
+  Index const nT = GlobalPool()->NumThreads();
+  Index const grain = grainIn > 0 ? grainIn : std::max<Index>(1, ni / (nT * 16));
+  Index const nB = (ni + grain - 1) / grain;
+  /* Don't try to schedule onto the pool from inside it */
+  Index const nW = GlobalPool()->CurrentThreadId() < 0 ? std::min(nT, nB) : 1;
 
   bool const report = label.size();
-  if (report) { Log::StartProgress(ni, label); }
-  if (nt == 1) {
-    for (Index ii = lo; ii < hi; ii++) {
-      f(ii);
-      if (report) { Log::Tick(); }
+  if (report) { Log::StartProgress(nB, label); }
+  auto block = [&](Index const ib, Index const iw) {
+    f(lo + ib * grain, std::min(lo + (ib + 1) * grain, hi), iw);
+    if (report) { Log::Tick(); }
+  };
+
+  if (nW == 1) {
+    for (Index ib = 0; ib < nB; ib++) {
+      block(ib, 0);
     }
   } else {
-    Eigen::Barrier barrier(static_cast<unsigned int>(ni));
-    for (Index ii = lo; ii < hi; ii++) {
-      GlobalPool()->Schedule([&barrier, &f, ii, report] {
-        f(ii);
+    std::vector<Worker> workers(nW);
+    for (Index iw = 0; iw < nW; iw++) {
+      workers[iw].next = iw * nB / nW;
+      workers[iw].end = (iw + 1) * nB / nW;
+    }
+    Eigen::Barrier    barrier(static_cast<unsigned int>(nW));
+    std::string const path = Profile::Enabled() ? Profile::CurrentPath() : std::string();
+    for (Index iw = 0; iw < nW; iw++) {
+      GlobalPool()->Schedule([&, iw] {
+        Profile::Inherit inherit(path);
+        Worker          &me = workers[iw];
+        auto const start = std::chrono::steady_clock::now();
+        while (true) {
+          Index ib = me.pop();
+          if (ib < 0) {
+            /* Find the worker with the most left to do and take half of it */
+            Index victim = -1, most = 0;
+            for (Index io = 1; io < nW; io++) {
+              Index const v = (iw + io) % nW;
+              Index const r = workers[v].remaining();
+              if (r > most) {
+                most = r;
+                victim = v;
+              }
+            }
+            Index sLo, sHi;
+            if (victim < 0) { break; }
+            if (!workers[victim].steal(sLo, sHi)) { continue; }
+            {
+              std::scoped_lock lock(me.m);
+              me.next = sLo;
+              me.end = sHi;
+            }
+            me.steals++;
+            continue;
+          }
+          block(ib, iw);
+          me.blocks++;
+        }
+        me.busy = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
         barrier.Notify();
-        if (report) { Log::Tick(); }
       });
     }
     barrier.Wait();
+    Profile::AddBusy(
+      std::transform_reduce(workers.begin(), workers.end(), 0., std::plus{}, [](Worker const &w) { return w.busy; }));
+    auto const [minW, maxW] =
+      std::minmax_element(workers.begin(), workers.end(), [](Worker const &a, Worker const &b) { return a.busy < b.busy; });
+    Index const steals =
+      std::transform_reduce(workers.begin(), workers.end(), 0L, std::plus{}, [](Worker const &w) { return w.steals; });
+    Log::Debug("ParallelFor {} {} blocks of {} on {} workers. Steals {} Time min {:.3f}s max {:.3f}s", label, nB, grain, nW,
+               steals, minW->busy, maxW->busy);
   }
   if (report) { Log::StopProgress(); }
 }
 
+void ParallelFor(Index const lo, Index const hi, Index const grain, RangeFunc f, std::string const &label)
+{
+  ParallelFor(lo, hi, grain, [&f](Index const ilo, Index const ihi, Index const) { f(ilo, ihi); }, label);
+}
+
+void For(ForFunc f, Index const lo, Index const hi, std::string const &label)
+{
+  ParallelFor(
+    lo, hi, 1,
+    [&f](Index const ilo, Index const ihi) {
+      for (Index ii = ilo; ii < ihi; ii++) {
+        f(ii);
+      }
+    },
+    label);
+}
+
 void For(ForFunc f, Index const n, std::string const &label) { For(f, 0, n, label); }
 
+namespace {
+/*
+ * Persistent threads outside the pool for Async. A stage run on one of them can still spread across the pool, and its
+ * scratch arena is kept between calls. An idle helper is reused if there is one, otherwise another is started, so an
+ * Async call never waits for a helper to free up.
+ */
+struct Helpers
+{
+  std::mutex                        m;
+  std::condition_variable           cv;
+  std::deque<std::function<void()>> queue;
+  std::vector<std::thread>          threads;
+  Index                             idle = 0;
+  bool                              stop = false;
+
+  ~Helpers()
+  {
+    {
+      std::scoped_lock lock(m);
+      stop = true;
+    }
+    cv.notify_all();
+    for (auto &t : threads) {
+      t.join();
+    }
+  }
+
+  void run(std::function<void()> f)
+  {
+    std::scoped_lock lock(m);
+    queue.push_back(std::move(f));
+    if ((Index)queue.size() <= idle) {
+      cv.notify_one();
+    } else {
+      threads.emplace_back([this] { loop(); });
+    }
+  }
+
+  void loop()
+  {
+    std::unique_lock lock(m);
+    while (true) {
+      idle++;
+      cv.wait(lock, [this] { return stop || !queue.empty(); });
+      idle--;
+      if (queue.empty()) { return; }
+      auto f = std::move(queue.front());
+      queue.pop_front();
+      lock.unlock();
+      f();
+      lock.lock();
+    }
+  }
+};
+
+Helpers helpers;
+} // namespace
+
+auto Async(std::function<void()> f) -> std::future<void>
+{
+  if (GlobalPool()->CurrentThreadId() >= 0) { return std::async(std::launch::deferred, std::move(f)); }
+  auto task = std::make_shared<std::packaged_task<void()>>([f = std::move(f), path = Profile::CurrentPath()] {
+    Profile::Inherit inherit(path);
+    f();
+  });
+  auto result = task->get_future();
+  helpers.run([task] { (*task)(); });
+  return result;
+}
+
+void Concurrent(ForFunc f, Index const n)
+{
+  if (n < 1) { return; }
+  std::vector<std::future<void>> futures;
+  futures.reserve(n - 1);
+  for (Index ii = 1; ii < n; ii++) {
+    futures.push_back(Async([&f, ii] { f(ii); }));
+  }
+  std::exception_ptr err;
+  try {
+    f(0);
+  } catch (...) {
+    err = std::current_exception();
+  }
+  for (auto &fut : futures) {
+    try {
+      fut.get();
+    } catch (...) {
+      if (!err) { err = std::current_exception(); }
+    }
+  }
+  if (err) { std::rethrow_exception(err); }
+}
+
 } // namespace Threads
 } // namespace rl
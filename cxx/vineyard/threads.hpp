@@ -2,6 +2,7 @@
 
 #include "types.hpp"
 #include <functional>
+#include <future>
 
 // Forward declare
 namespace Eigen {
@@ -21,5 +22,28 @@ using ForFunc = std::function<void(Index const index)>;
 void For(ForFunc f, Index const n, std::string const &label = "");
 void For(ForFunc f, Index const lo, Index const hi, std::string const &label = "");
 
+/*
+ * Work-stealing parallel loop over [lo, hi). The range is cut into blocks of grain indices (grain < 1 picks a size
+ * automatically). Each worker starts with a contiguous share of the blocks and, when it runs dry, steals the back half
+ * of the largest remaining share. f is called with the block range and, optionally, the worker index which is always
+ * less than GlobalThreadCount() so can be used to index per-thread scratch space.
+ */
+using RangeFunc = std::function<void(Index const lo, Index const hi)>;
+using WorkerRangeFunc = std::function<void(Index const lo, Index const hi, Index const worker)>;
+void ParallelFor(Index const lo, Index const hi, Index const grain, RangeFunc f, std::string const &label = "");
+void ParallelFor(Index const lo, Index const hi, Index const grain, WorkerRangeFunc f, std::string const &label = "");
+
+/*
+ * Run f on a persistent helper thread alongside the caller, so that two stages that each use the pool can overlap. From
+ * inside the pool f is deferred and runs when the future is waited on.
+ */
+auto Async(std::function<void()> f) -> std::future<void>;
+
+/*
+ * Run f(0) ... f(n - 1) at the same time, f(0) on the caller and the rest via Async, and wait for all of them. Each call
+ * can still use the pool internally. The first exception thrown is rethrown once every call has finished.
+ */
+void Concurrent(ForFunc f, Index const n);
+
 } // namespace Threads
 } // namespace rl